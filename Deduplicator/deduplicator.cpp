@@ -0,0 +1,313 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "deduplicator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    // Chunks are cut using the FastCDC algorithm (Xia et al., USENIX ATC 2016). The gear table
+    // maps each byte to a pseudo-random 64-bit value, generated here with SplitMix64.
+    constexpr auto GearTable = []
+    {
+        std::array<uint64_t, 256> table = {};
+        uint64_t state = 0x2545f4914f6cdd1d;
+
+        for (auto& value : table)
+        {
+            uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            value = z ^ (z >> 31);
+        }
+
+        return table;
+    }();
+
+    // Amount of input buffered before searching for cut points
+    constexpr size_t PendingCapacity = 1024 * 1024;
+
+    // Masks use the high bits of the gear hash, which depend on the last 64 input bytes
+    constexpr auto makeMask(int bits) -> uint64_t
+    {
+        return ~uint64_t(0) << (64 - bits);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Deduplicator::Deduplicator(const DeduplicatorSettings& settings)
+    : m_settings(settings)
+{
+    assert(std::has_single_bit(settings.averageChunkSize));
+    assert(settings.minimumChunkSize < settings.averageChunkSize);
+    assert(settings.averageChunkSize < settings.maximumChunkSize);
+    assert(settings.maximumChunkSize <= PendingCapacity);
+
+    // Normalized chunking: cut points are harder to find before the average size is reached
+    // and easier afterwards, which narrows the distribution of chunk sizes.
+    const int bits = std::countr_zero(settings.averageChunkSize);
+
+    m_smallMask = makeMask(bits + 2);
+    m_largeMask = makeMask(bits - 2);
+
+    m_pending.reserve(PendingCapacity);
+    m_index.resize(1024, 0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Deduplicator::append(std::span<const uint8_t> data)
+{
+    m_inputSize += data.size();
+
+    while (!data.empty())
+    {
+        const size_t count = std::min(data.size(), PendingCapacity - m_pending.size());
+
+        m_pending.insert(m_pending.end(), data.begin(), data.begin() + count);
+        data = data.subspan(count);
+
+        std::span<const uint8_t> pending = m_pending;
+
+        while (const size_t cut = findCutPoint(pending, false))
+        {
+            addChunk(pending.first(cut));
+            pending = pending.subspan(cut);
+        }
+
+        m_pending.erase(m_pending.begin(), m_pending.end() - pending.size());
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Deduplicator::finish()
+{
+    std::span<const uint8_t> pending = m_pending;
+
+    while (const size_t cut = findCutPoint(pending, true))
+    {
+        addChunk(pending.first(cut));
+        pending = pending.subspan(cut);
+    }
+
+    m_pending.clear();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::manifest() const -> const std::vector<size_t>&
+{
+    return m_manifest;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::chunks() const -> const std::vector<Chunk>&
+{
+    return m_chunks;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::store() const -> const std::vector<uint8_t>&
+{
+    return m_store;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::inputSize() const -> size_t
+{
+    return m_inputSize;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::storedSize() const -> size_t
+{
+    return m_store.size();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::restore() const -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> output;
+    output.reserve(m_inputSize - m_pending.size());
+
+    for (size_t index : m_manifest)
+    {
+        const auto& chunk = m_chunks[index];
+        output.insert(output.end(), m_store.begin() + chunk.offset,
+                      m_store.begin() + chunk.offset + chunk.size);
+    }
+
+    return output;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::chunkSizes(std::span<const uint8_t> data) const -> std::vector<size_t>
+{
+    std::vector<size_t> sizes;
+
+    while (const size_t cut = findCutPoint(data, true))
+    {
+        sizes.push_back(cut);
+        data = data.subspan(cut);
+    }
+
+    return sizes;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::findCutPoint(std::span<const uint8_t> data, bool last) const -> size_t
+{
+    if (data.size() <= m_settings.minimumChunkSize)
+        return last ? data.size() : 0;
+
+    const size_t size = std::min(data.size(), m_settings.maximumChunkSize);
+    const size_t normalSize = std::min(size, m_settings.averageChunkSize);
+
+    uint64_t hash = 0;
+    size_t i = m_settings.minimumChunkSize;
+
+    for (; i < normalSize; ++i)
+    {
+        hash = (hash << 1) + GearTable[data[i]];
+        if (!(hash & m_smallMask))
+            return i + 1;
+    }
+
+    for (; i < size; ++i)
+    {
+        hash = (hash << 1) + GearTable[data[i]];
+        if (!(hash & m_largeMask))
+            return i + 1;
+    }
+
+    // Without a cut point, more data may still produce one unless the maximum size is reached
+    return (last || size == m_settings.maximumChunkSize) ? size : 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Deduplicator::addChunk(std::span<const uint8_t> data)
+{
+    sha256_result result;
+    sha256_compute(data.data(), static_cast<uint32_t>(data.size()), &result);
+
+    Fingerprint fingerprint;
+    std::memcpy(fingerprint.data(), result.hash, fingerprint.size());
+
+    size_t index = findFingerprint(fingerprint);
+
+    if (index == m_chunks.size())
+    {
+        m_chunks.push_back({ fingerprint, m_store.size(), data.size() });
+        m_store.insert(m_store.end(), data.begin(), data.end());
+
+        insertFingerprint(index);
+    }
+
+    m_manifest.push_back(index);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::findFingerprint(const Fingerprint& fingerprint) const -> size_t
+{
+    const size_t mask = m_index.size() - 1;
+
+    for (size_t slot = hashOf(fingerprint) & mask; m_index[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const size_t chunk = m_index[slot] - 1;
+
+        if (m_chunks[chunk].fingerprint == fingerprint)
+            return chunk;
+    }
+
+    return m_chunks.size();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Deduplicator::insertFingerprint(size_t chunk)
+{
+    // Keep load factor below 0.5 to keep probe sequences short
+    if (2 * m_chunks.size() > m_index.size())
+    {
+        const auto index = std::exchange(m_index, std::vector<size_t>(2 * m_index.size(), 0));
+
+        for (size_t entry : index)
+        {
+            if (entry != 0)
+                placeFingerprint(entry - 1);
+        }
+    }
+
+    placeFingerprint(chunk);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Deduplicator::placeFingerprint(size_t chunk)
+{
+    const size_t mask = m_index.size() - 1;
+
+    size_t slot = hashOf(m_chunks[chunk].fingerprint) & mask;
+    while (m_index[slot] != 0)
+        slot = (slot + 1) & mask;
+
+    m_index[slot] = chunk + 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Deduplicator::hashOf(const Fingerprint& fingerprint) -> size_t
+{
+    // The fingerprints are uniformly distributed, so any of their bytes make a good hash
+    size_t hash;
+    std::memcpy(&hash, fingerprint.data(), sizeof(hash));
+    return hash;
+}
+
+// ---------------------------------------------------------------------------------------------- //
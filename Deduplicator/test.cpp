@@ -0,0 +1,111 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "deduplicator.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto main() -> int
+{
+    static constexpr size_t BlockSize = 1024 * 1024;
+    static constexpr size_t BlockCount = 16;
+
+    // Simulate a series of backup images that differ only in a few small modifications
+    std::mt19937_64 random(42);
+
+    std::vector<uint8_t> image(BlockSize);
+    for (auto& byte : image)
+        byte = static_cast<uint8_t>(random());
+
+    std::vector<uint8_t> input;
+
+    for (size_t i = 0; i < BlockCount; ++i)
+    {
+        input.insert(input.end(), image.begin(), image.end());
+
+        const size_t position = random() % image.size();
+        image.insert(image.begin() + position, { 0xde, 0xad, 0xbe, 0xef });
+        image.resize(BlockSize);
+    }
+
+    Deduplicator oneShot;
+
+    const auto start = std::chrono::steady_clock::now();
+    oneShot.append(input);
+    oneShot.finish();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    assert(oneShot.restore() == input);
+
+    // Chunk boundaries must not depend on how the input is split up
+    Deduplicator streamed;
+
+    for (size_t position = 0; position < input.size(); )
+    {
+        const size_t count = std::min<size_t>(random() % 100000, input.size() - position);
+        streamed.append(std::span(input).subspan(position, count));
+        position += count;
+    }
+
+    streamed.finish();
+
+    assert(streamed.manifest() == oneShot.manifest());
+    assert(streamed.store() == oneShot.store());
+
+    // Chunking alone, without fingerprints
+    const auto chunkingStart = std::chrono::steady_clock::now();
+    const auto sizes = oneShot.chunkSizes(input);
+    const std::chrono::duration<double> chunkingElapsed =
+        std::chrono::steady_clock::now() - chunkingStart;
+
+    assert(sizes.size() == oneShot.manifest().size());
+
+    for (size_t i = 0; i < sizes.size(); ++i)
+        assert(sizes[i] == oneShot.chunks()[oneShot.manifest()[i]].size);
+
+    std::cout << "Input size: " << oneShot.inputSize() << " bytes\n"
+              << "Stored size: " << oneShot.storedSize() << " bytes\n"
+              << "Chunks: " << oneShot.manifest().size() << " ("
+              << oneShot.chunks().size() << " unique)\n"
+              << "Throughput: " << input.size() / elapsed.count() / 1e6 << " MB/s\n"
+              << "Chunking only: " << input.size() / chunkingElapsed.count() / 1e6 << " MB/s\n";
+
+    std::cout << "All tests passed." << std::endl;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,184 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+/* Benchmark for SHA-256 library. Reports throughput and cycles per byte of the compiled-in
+   transform for message sizes from 0 bytes to 1 GiB. Cycles are read from the time-stamp
+   counter and are therefore only available on x86. */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "sha256.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_CYCLE_COUNTER 1
+#endif
+
+// ---------------------------------------------------------------------------------------------- //
+
+#ifdef SHA256_SMALL_FOOTPRINT
+#define TRANSFORM_NAME "small footprint"
+#else
+#define TRANSFORM_NAME "default"
+#endif
+
+/* Larger messages are hashed by feeding this buffer repeatedly */
+#define BUFFER_SIZE (16 * 1024 * 1024)
+
+/* Each size is hashed repeatedly for at least this long */
+#define MINIMUM_DURATION 0.5
+
+// ---------------------------------------------------------------------------------------------- //
+
+static const uint64_t message_sizes[] =
+{
+    0, 1, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576,
+    16777216, 268435456, 1073741824
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+static double seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static uint64_t cycles(void)
+{
+#ifdef HAVE_CYCLE_COUNTER
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void hash_message(const uint8_t *buffer, uint64_t size, struct sha256_result *result)
+{
+    struct sha256_context ctx;
+    sha256_init(&ctx);
+
+    while (size > 0)
+    {
+        const uint64_t count = size < BUFFER_SIZE ? size : BUFFER_SIZE;
+
+        sha256_update(&ctx, buffer, (size_t)count);
+        size -= count;
+    }
+
+    sha256_finish(&ctx, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+int main(void)
+{
+    uint8_t *buffer = (uint8_t *)malloc(BUFFER_SIZE);
+    uint8_t checksum = 0;
+
+    if (!buffer)
+    {
+        printf("Unable to allocate buffer\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < BUFFER_SIZE; ++i)
+        buffer[i] = (uint8_t)(i * 2654435761u >> 24);
+
+    printf("SHA-256 benchmark, %s transform\n\n", TRANSFORM_NAME);
+    printf("%12s %12s %14s %12s %14s\n", "Size [B]", "Iterations", "Time/hash [us]",
+           "MB/s", "Cycles/byte");
+
+    for (size_t i = 0; i < sizeof(message_sizes) / sizeof(message_sizes[0]); ++i)
+    {
+        const uint64_t size = message_sizes[i];
+        struct sha256_result result;
+
+        uint64_t iterations = 0;
+        uint64_t start_cycles;
+        double start, elapsed;
+        double elapsed_cycles;
+
+        /* Warm up caches */
+        hash_message(buffer, size < BUFFER_SIZE ? size : 0, &result);
+
+        start = seconds();
+        start_cycles = cycles();
+
+        do
+        {
+            hash_message(buffer, size, &result);
+            checksum ^= result.hash[0];
+
+            ++iterations;
+            elapsed = seconds() - start;
+        }
+        while (elapsed < MINIMUM_DURATION);
+
+        elapsed_cycles = (double)(cycles() - start_cycles);
+
+        printf("%12llu %12llu %14.3f", (unsigned long long)size, (unsigned long long)iterations,
+               1e6 * elapsed / iterations);
+
+        if (size > 0)
+        {
+            printf(" %12.1f", size * iterations / elapsed / 1e6);
+
+#ifdef HAVE_CYCLE_COUNTER
+            printf(" %14.2f", elapsed_cycles / (size * iterations));
+#else
+            printf(" %14s", "n/a");
+#endif
+        }
+        else
+            printf(" %12s %14s", "-", "-");
+
+        printf("\n");
+    }
+
+    /* Keep the compiler from optimizing away the hashing */
+    printf("\nChecksum: %02x\n", checksum);
+
+    free(buffer);
+    return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -56,28 +56,95 @@ static const uint32_t _sha256_round_constants[64] =
 
 // ---------------------------------------------------------------------------------------------- //
 
-struct _sha256_ctx
+#ifdef SHA256_SMALL_FOOTPRINT
+
+/* Compact variant for targets with little stack space: Only a 16-word window of the message
+   schedule is kept and all 64 rounds are unrolled. Instead of shifting the working variables
+   after each round, the macro arguments are rotated, which allows them to stay in registers. */
+
+#define _SHA256_SIGMA0(x) (_SHA256_ROTATE_RIGHT(x, 2) ^ _SHA256_ROTATE_RIGHT(x, 13) ^ \
+                           _SHA256_ROTATE_RIGHT(x, 22))
+#define _SHA256_SIGMA1(x) (_SHA256_ROTATE_RIGHT(x, 6) ^ _SHA256_ROTATE_RIGHT(x, 11) ^ \
+                           _SHA256_ROTATE_RIGHT(x, 25))
+
+#define _SHA256_GAMMA0(x) (_SHA256_ROTATE_RIGHT(x, 7) ^ _SHA256_ROTATE_RIGHT(x, 18) ^ ((x) >> 3))
+#define _SHA256_GAMMA1(x) (_SHA256_ROTATE_RIGHT(x, 17) ^ _SHA256_ROTATE_RIGHT(x, 19) ^ ((x) >> 10))
+
+#define _SHA256_CH(e,f,g)  ((g) ^ ((e) & ((f) ^ (g))))
+#define _SHA256_MAJ(a,b,c) (((a) & (b)) | ((c) & ((a) | (b))))
+
+/* Word i of the message schedule, computed in place from the previous 16 words */
+#define _SHA256_SCHEDULE(i) \
+    ((i) < 16 ? w[i] : (w[(i) & 15] += _SHA256_GAMMA1(w[((i) - 2) & 15]) + w[((i) - 7) & 15] + \
+                                       _SHA256_GAMMA0(w[((i) - 15) & 15])))
+
+#define _SHA256_ROUND(a,b,c,d,e,f,g,h,i) \
+    do { \
+        temp1 = (h) + _SHA256_SIGMA1(e) + _SHA256_CH(e, f, g) + \
+                _sha256_round_constants[i] + _SHA256_SCHEDULE(i); \
+        (d) += temp1; \
+        (h) = temp1 + _SHA256_SIGMA0(a) + _SHA256_MAJ(a, b, c); \
+    } while (0)
+
+#define _SHA256_ROUND8(i) \
+    do { \
+        _SHA256_ROUND(a, b, c, d, e, f, g, h, (i) + 0); \
+        _SHA256_ROUND(h, a, b, c, d, e, f, g, (i) + 1); \
+        _SHA256_ROUND(g, h, a, b, c, d, e, f, (i) + 2); \
+        _SHA256_ROUND(f, g, h, a, b, c, d, e, (i) + 3); \
+        _SHA256_ROUND(e, f, g, h, a, b, c, d, (i) + 4); \
+        _SHA256_ROUND(d, e, f, g, h, a, b, c, (i) + 5); \
+        _SHA256_ROUND(c, d, e, f, g, h, a, b, (i) + 6); \
+        _SHA256_ROUND(b, c, d, e, f, g, h, a, (i) + 7); \
+    } while (0)
+
+static void _sha256_transform(uint32_t *hash, const uint8_t *chunk)
 {
-    uint32_t hash[8];
-};
+    /* Circular message schedule */
+    uint32_t w[16];
 
-// ---------------------------------------------------------------------------------------------- //
+    uint32_t a, b, c, d, e, f, g, h;
+    uint32_t temp1;
 
-void _sha256_init(struct _sha256_ctx *ctx)
-{
-    ctx->hash[0] = 0x6a09e667;
-    ctx->hash[1] = 0xbb67ae85;
-    ctx->hash[2] = 0x3c6ef372;
-    ctx->hash[3] = 0xa54ff53a;
-    ctx->hash[4] = 0x510e527f;
-    ctx->hash[5] = 0x9b05688c;
-    ctx->hash[6] = 0x1f83d9ab;
-    ctx->hash[7] = 0x5be0cd19;
+    uint32_t i;
+
+    for (i = 0; i < 16; ++i)
+    {
+        w[i] = ((uint32_t)chunk[i*4] << 24) | ((uint32_t)chunk[i*4 + 1] << 16) |
+               ((uint32_t)chunk[i*4 + 2] << 8) | ((uint32_t)chunk[i*4 + 3]);
+    }
+
+    a = hash[0];
+    b = hash[1];
+    c = hash[2];
+    d = hash[3];
+    e = hash[4];
+    f = hash[5];
+    g = hash[6];
+    h = hash[7];
+
+    _SHA256_ROUND8(0);
+    _SHA256_ROUND8(8);
+    _SHA256_ROUND8(16);
+    _SHA256_ROUND8(24);
+    _SHA256_ROUND8(32);
+    _SHA256_ROUND8(40);
+    _SHA256_ROUND8(48);
+    _SHA256_ROUND8(56);
+
+    hash[0] += a;
+    hash[1] += b;
+    hash[2] += c;
+    hash[3] += d;
+    hash[4] += e;
+    hash[5] += f;
+    hash[6] += g;
+    hash[7] += h;
 }
 
-// ---------------------------------------------------------------------------------------------- //
+#else /* SHA256_SMALL_FOOTPRINT */
 
-void _sha256_transform(struct _sha256_ctx *ctx, uint8_t *chunk)
+static void _sha256_transform(uint32_t *hash, const uint8_t *chunk)
 {
     /* Message schedule array */
     uint32_t w[64];
@@ -91,7 +158,10 @@ void _sha256_transform(struct _sha256_ctx *ctx, uint8_t *chunk)
 
     /* Copy chunk into first 16 words of message schedule array */
     for (i = 0; i < 16; ++i)
-        w[i] = (chunk[i*4] << 24) | (chunk[i*4 + 1] << 16) | (chunk[i*4 + 2] << 8) | (chunk[i*4 + 3]);
+    {
+        w[i] = ((uint32_t)chunk[i*4] << 24) | ((uint32_t)chunk[i*4 + 1] << 16) |
+               ((uint32_t)chunk[i*4 + 2] << 8) | ((uint32_t)chunk[i*4 + 3]);
+    }
 
     /* Extend first 16 words into remaining 48 words of message schedule array */
     for (i = 16 ; i < 64; ++i)
@@ -102,14 +172,14 @@ void _sha256_transform(struct _sha256_ctx *ctx, uint8_t *chunk)
     }
 
     /* Initialize working variables to current hash value */
-    a = ctx->hash[0];
-    b = ctx->hash[1];
-    c = ctx->hash[2];
-    d = ctx->hash[3];
-    e = ctx->hash[4];
-    f = ctx->hash[5];
-    g = ctx->hash[6];
-    h = ctx->hash[7];
+    a = hash[0];
+    b = hash[1];
+    c = hash[2];
+    d = hash[3];
+    e = hash[4];
+    f = hash[5];
+    g = hash[6];
+    h = hash[7];
 
     /* Run compression loop */
     for (i = 0; i < 64; ++i)
@@ -133,41 +203,99 @@ void _sha256_transform(struct _sha256_ctx *ctx, uint8_t *chunk)
     }
 
     /* Add compressed chunk to current hash value */
-    ctx->hash[0] += a;
-    ctx->hash[1] += b;
-    ctx->hash[2] += c;
-    ctx->hash[3] += d;
-    ctx->hash[4] += e;
-    ctx->hash[5] += f;
-    ctx->hash[6] += g;
-    ctx->hash[7] += h;
+    hash[0] += a;
+    hash[1] += b;
+    hash[2] += c;
+    hash[3] += d;
+    hash[4] += e;
+    hash[5] += f;
+    hash[6] += g;
+    hash[7] += h;
 }
 
+#endif /* SHA256_SMALL_FOOTPRINT */
+
 // ---------------------------------------------------------------------------------------------- //
 
 void sha256_compute(const uint8_t *buffer, uint32_t length, struct sha256_result *result)
 {
-    uint32_t i;
+    struct sha256_context ctx;
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, buffer, length);
+    sha256_finish(&ctx, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void sha256_init(struct sha256_context *ctx)
+{
+    ctx->hash[0] = 0x6a09e667;
+    ctx->hash[1] = 0xbb67ae85;
+    ctx->hash[2] = 0x3c6ef372;
+    ctx->hash[3] = 0xa54ff53a;
+    ctx->hash[4] = 0x510e527f;
+    ctx->hash[5] = 0x9b05688c;
+    ctx->hash[6] = 0x1f83d9ab;
+    ctx->hash[7] = 0x5be0cd19;
 
-    uint8_t chunk[64];
-    uint32_t chunk_position = 0;
+    ctx->chunk_position = 0;
+    ctx->length = 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
 
-    uint64_t message_length = length * 8;
+void sha256_update(struct sha256_context *ctx, const uint8_t *buffer, size_t length)
+{
+    size_t count;
 
-    struct _sha256_ctx ctx;
-    _sha256_init(&ctx);
+    ctx->length += length;
 
-    /* Break message into 512-bit chunks */
-    for (i = 0; i < length; ++i)
+    /* Complete a previously started chunk first */
+    if (ctx->chunk_position > 0)
     {
-        chunk[chunk_position++] = buffer[i];
-        if (chunk_position == 64)
-        {
-            _sha256_transform(&ctx, chunk);
-            chunk_position = 0;
-        }
+        count = 64 - ctx->chunk_position;
+        if (count > length)
+            count = length;
+
+        memcpy(ctx->chunk + ctx->chunk_position, buffer, count);
+        ctx->chunk_position += (uint32_t)count;
+
+        buffer += count;
+        length -= count;
+
+        if (ctx->chunk_position < 64)
+            return;
+
+        _sha256_transform(ctx->hash, ctx->chunk);
+        ctx->chunk_position = 0;
     }
 
+    /* Process whole chunks directly from the input buffer */
+    while (length >= 64)
+    {
+        _sha256_transform(ctx->hash, buffer);
+
+        buffer += 64;
+        length -= 64;
+    }
+
+    /* Keep remainder for next update */
+    memcpy(ctx->chunk, buffer, length);
+    ctx->chunk_position = (uint32_t)length;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void sha256_finish(struct sha256_context *ctx, struct sha256_result *result)
+{
+    uint32_t i;
+
+    uint8_t *chunk = ctx->chunk;
+    uint32_t chunk_position = ctx->chunk_position;
+
+    const uint64_t message_length = ctx->length * 8;
+
     /* Pad remaining buffer */
     if (chunk_position < 56)
     {
@@ -181,7 +309,7 @@ void sha256_compute(const uint8_t *buffer, uint32_t length, struct sha256_result
         while (chunk_position < 64)
             chunk[chunk_position++] = 0x00;
 
-        _sha256_transform(&ctx, chunk);
+        _sha256_transform(ctx->hash, chunk);
 
         memset(chunk, 0, 56);
         chunk_position = 56;
@@ -197,15 +325,15 @@ void sha256_compute(const uint8_t *buffer, uint32_t length, struct sha256_result
     chunk[62] = message_length >> 8;
     chunk[63] = message_length;
 
-    _sha256_transform(&ctx, chunk);
+    _sha256_transform(ctx->hash, chunk);
 
     /* Produce final hash value */
     for (i = 0; i < 8; ++i)
     {
-        result->hash[i*4 + 0] = ctx.hash[i] >> 24;
-        result->hash[i*4 + 1] = ctx.hash[i] >> 16;
-        result->hash[i*4 + 2] = ctx.hash[i] >> 8;
-        result->hash[i*4 + 3] = ctx.hash[i];
+        result->hash[i*4 + 0] = ctx->hash[i] >> 24;
+        result->hash[i*4 + 1] = ctx->hash[i] >> 16;
+        result->hash[i*4 + 2] = ctx->hash[i] >> 8;
+        result->hash[i*4 + 3] = ctx->hash[i];
     }
 }
 
@@ -34,6 +34,7 @@
 #ifndef ISF_SHA256_H
 #define ISF_SHA256_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -47,8 +48,21 @@ struct sha256_result
     uint8_t hash[SHA256_HASH_LENGTH];
 };
 
+struct sha256_context
+{
+    uint32_t hash[8];
+    uint8_t chunk[64];
+    uint32_t chunk_position;
+    uint64_t length;
+};
+
 void sha256_compute(const uint8_t *buffer, uint32_t length, struct sha256_result *result);
 
+/* Incremental interface for messages that are not available in one piece */
+void sha256_init(struct sha256_context *ctx);
+void sha256_update(struct sha256_context *ctx, const uint8_t *buffer, size_t length);
+void sha256_finish(struct sha256_context *ctx, struct sha256_result *result);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
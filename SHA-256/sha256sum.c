@@ -0,0 +1,954 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+/* Drop-in replacement for GNU sha256sum. Output is identical to coreutils, but input files are
+   memory-mapped and hashed in parallel by a pool of worker threads. Requires a POSIX system. */
+
+#define _GNU_SOURCE
+
+#include "sha256.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------------------------------------- //
+
+#define PROGRAM_NAME "sha256sum"
+#define READ_BUFFER_SIZE (128 * 1024)
+
+// ---------------------------------------------------------------------------------------------- //
+
+struct job
+{
+    char *name;
+    uint8_t expected[SHA256_HASH_LENGTH];   /* only used in check mode */
+    size_t misformatted_line;               /* line number reported by --warn, not hashed */
+
+    struct sha256_result result;
+    int error;
+    bool done;
+};
+
+struct job_list
+{
+    struct job *jobs;
+    size_t count;
+    size_t capacity;
+
+    atomic_size_t next;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t finished;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+static bool binary_mode = false;
+static bool binary_or_text = false;
+static bool bsd_tag = false;
+static bool zero_terminated = false;
+
+static bool check_mode = false;
+static bool quiet = false;
+static bool status_only = false;
+static bool strict = false;
+static bool warn = false;
+static bool ignore_missing = false;
+
+static unsigned thread_count = 0;
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void *xmalloc(size_t size)
+{
+    void *p = malloc(size);
+    if (!p)
+    {
+        fprintf(stderr, "%s: memory exhausted\n", PROGRAM_NAME);
+        exit(EXIT_FAILURE);
+    }
+    return p;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/* Quote a file name for diagnostics the way coreutils' quotef() does for common cases */
+static void print_quoted(FILE *stream, const char *name)
+{
+    const char *p;
+    bool plain = (*name != '\0');
+
+    for (p = name; *p && plain; ++p)
+    {
+        if (!isalnum((unsigned char)*p) && !strchr("_./-+,:@%^=", *p))
+            plain = false;
+    }
+
+    if (plain)
+    {
+        fputs(name, stream);
+        return;
+    }
+
+    fputc('\'', stream);
+    for (p = name; *p; ++p)
+    {
+        if (*p == '\'')
+            fputs("'\\''", stream);
+        else
+            fputc(*p, stream);
+    }
+    fputc('\'', stream);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void print_error(const char *name, int error)
+{
+    fflush(stdout);
+    fprintf(stderr, "%s: ", PROGRAM_NAME);
+    print_quoted(stderr, name);
+    fprintf(stderr, ": %s\n", strerror(error));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void print_filename(const char *name, bool escape)
+{
+    if (!escape)
+    {
+        fputs(name, stdout);
+        return;
+    }
+
+    for (; *name; ++name)
+    {
+        if (*name == '\\')
+            fputs("\\\\", stdout);
+        else if (*name == '\n')
+            fputs("\\n", stdout);
+        else if (*name == '\r')
+            fputs("\\r", stdout);
+        else
+            putchar(*name);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void print_hash(const struct sha256_result *result)
+{
+    static const char digits[] = "0123456789abcdef";
+    char text[2 * SHA256_HASH_LENGTH];
+
+    for (int i = 0; i < SHA256_HASH_LENGTH; ++i)
+    {
+        text[2*i + 0] = digits[result->hash[i] >> 4];
+        text[2*i + 1] = digits[result->hash[i] & 0x0f];
+    }
+
+    fwrite(text, 1, sizeof(text), stdout);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static int hash_descriptor(int fd, uint8_t *buffer, struct sha256_result *result)
+{
+    struct sha256_context ctx;
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+        return errno;
+
+    if (S_ISDIR(st.st_mode))
+        return EISDIR;
+
+    sha256_init(&ctx);
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED)
+        {
+            madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+            sha256_update(&ctx, (const uint8_t *)data, (size_t)st.st_size);
+            munmap(data, (size_t)st.st_size);
+
+            sha256_finish(&ctx, result);
+            return 0;
+        }
+    }
+
+    /* Pipes, devices or files that cannot be mapped are read sequentially */
+    for (;;)
+    {
+        const ssize_t count = read(fd, buffer, READ_BUFFER_SIZE);
+
+        if (count == 0)
+            break;
+
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return errno;
+        }
+
+        sha256_update(&ctx, buffer, (size_t)count);
+    }
+
+    sha256_finish(&ctx, result);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static int hash_file(const char *name, uint8_t *buffer, struct sha256_result *result)
+{
+    int fd, error;
+
+    if (strcmp(name, "-") == 0)
+        return hash_descriptor(STDIN_FILENO, buffer, result);
+
+    fd = open(name, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return errno;
+
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    error = hash_descriptor(fd, buffer, result);
+    close(fd);
+
+    return error;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void *worker(void *arg)
+{
+    struct job_list *list = (struct job_list *)arg;
+    uint8_t *buffer = (uint8_t *)xmalloc(READ_BUFFER_SIZE);
+
+    for (;;)
+    {
+        const size_t index = atomic_fetch_add(&list->next, 1);
+        struct job *job;
+
+        if (index >= list->count)
+            break;
+
+        job = &list->jobs[index];
+
+        if (job->misformatted_line == 0)
+            job->error = hash_file(job->name, buffer, &job->result);
+
+        pthread_mutex_lock(&list->mutex);
+        job->done = true;
+        pthread_cond_broadcast(&list->finished);
+        pthread_mutex_unlock(&list->mutex);
+    }
+
+    free(buffer);
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void job_list_init(struct job_list *list)
+{
+    list->jobs = NULL;
+    list->count = 0;
+    list->capacity = 0;
+
+    atomic_init(&list->next, 0);
+
+    pthread_mutex_init(&list->mutex, NULL);
+    pthread_cond_init(&list->finished, NULL);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void job_list_free(struct job_list *list)
+{
+    for (size_t i = 0; i < list->count; ++i)
+        free(list->jobs[i].name);
+
+    free(list->jobs);
+
+    pthread_mutex_destroy(&list->mutex);
+    pthread_cond_destroy(&list->finished);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static struct job *job_list_add(struct job_list *list, const char *name)
+{
+    struct job *job;
+
+    if (list->count == list->capacity)
+    {
+        list->capacity = list->capacity ? 2 * list->capacity : 64;
+        list->jobs = (struct job *)realloc(list->jobs, list->capacity * sizeof(struct job));
+
+        if (!list->jobs)
+        {
+            fprintf(stderr, "%s: memory exhausted\n", PROGRAM_NAME);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    job = &list->jobs[list->count++];
+    memset(job, 0, sizeof(*job));
+
+    job->name = strdup(name);
+    if (!job->name)
+    {
+        fprintf(stderr, "%s: memory exhausted\n", PROGRAM_NAME);
+        exit(EXIT_FAILURE);
+    }
+
+    return job;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/* Starts hashing all jobs in the background. Results become available in any order and must be
+   collected with job_list_wait(), which allows printing them in their original order. */
+static pthread_t *job_list_start(struct job_list *list, unsigned *started)
+{
+    unsigned threads = thread_count;
+    pthread_t *workers;
+
+    if (threads == 0)
+    {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned)online : 1;
+    }
+
+    if (threads > list->count)
+        threads = (unsigned)list->count;
+
+    workers = (pthread_t *)xmalloc((threads + 1) * sizeof(pthread_t));
+    *started = 0;
+
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        if (pthread_create(&workers[*started], NULL, worker, list) == 0)
+            ++(*started);
+    }
+
+    /* Fall back to hashing in the calling thread if no worker could be created */
+    if (*started == 0 && list->count > 0)
+        worker(list);
+
+    return workers;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static struct job *job_list_wait(struct job_list *list, size_t index)
+{
+    struct job *job = &list->jobs[index];
+
+    pthread_mutex_lock(&list->mutex);
+    while (!job->done)
+        pthread_cond_wait(&list->finished, &list->mutex);
+    pthread_mutex_unlock(&list->mutex);
+
+    return job;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void job_list_join(pthread_t *workers, unsigned started)
+{
+    for (unsigned i = 0; i < started; ++i)
+        pthread_join(workers[i], NULL);
+
+    free(workers);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static bool compute_files(char **names, int count)
+{
+    struct job_list list;
+    pthread_t *workers;
+    unsigned started;
+    bool ok = true;
+
+    job_list_init(&list);
+
+    for (int i = 0; i < count; ++i)
+        job_list_add(&list, names[i]);
+
+    workers = job_list_start(&list, &started);
+
+    for (size_t i = 0; i < list.count; ++i)
+    {
+        const struct job *job = job_list_wait(&list, i);
+        bool escape;
+
+        if (job->error)
+        {
+            print_error(job->name, job->error);
+            ok = false;
+            continue;
+        }
+
+        escape = !zero_terminated && strpbrk(job->name, "\\\n\r") != NULL;
+
+        if (bsd_tag)
+        {
+            if (escape)
+                putchar('\\');
+
+            fputs("SHA256 (", stdout);
+            print_filename(job->name, escape);
+            fputs(") = ", stdout);
+            print_hash(&job->result);
+        }
+        else
+        {
+            if (escape)
+                putchar('\\');
+
+            print_hash(&job->result);
+            putchar(' ');
+            putchar(binary_mode ? '*' : ' ');
+            print_filename(job->name, escape);
+        }
+
+        putchar(zero_terminated ? '\0' : '\n');
+    }
+
+    job_list_join(workers, started);
+    job_list_free(&list);
+
+    return ok;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static bool parse_hash(const char *text, uint8_t *hash)
+{
+    for (int i = 0; i < SHA256_HASH_LENGTH; ++i)
+    {
+        const int high = hex_value(text[2*i]);
+        const int low = high < 0 ? -1 : hex_value(text[2*i + 1]);
+
+        if (low < 0)
+            return false;
+
+        hash[i] = (uint8_t)((high << 4) | low);
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/* Undo the escaping applied by print_filename(), in place */
+static bool unescape_filename(char *name)
+{
+    char *out = name;
+
+    for (; *name; ++name)
+    {
+        if (*name != '\\')
+        {
+            *out++ = *name;
+            continue;
+        }
+
+        ++name;
+
+        if (*name == '\\')
+            *out++ = '\\';
+        else if (*name == 'n')
+            *out++ = '\n';
+        else if (*name == 'r')
+            *out++ = '\r';
+        else
+            return false;
+    }
+
+    *out = '\0';
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/* Parses both the default and the BSD-style (--tag) formats */
+static bool parse_check_line(char *line, uint8_t *hash, char **name)
+{
+    bool escaped = false;
+    size_t length;
+
+    while (*line == ' ' || *line == '\t')
+        ++line;
+
+    if (*line == '\\')
+    {
+        escaped = true;
+        ++line;
+    }
+
+    if (strncmp(line, "SHA256 (", 8) == 0)
+    {
+        char *end;
+
+        line += 8;
+        end = strstr(line, ") = ");
+
+        /* The file name itself may contain ") = ", use the last occurrence */
+        while (end && strstr(end + 1, ") = "))
+            end = strstr(end + 1, ") = ");
+
+        if (!end)
+            return false;
+
+        *end = '\0';
+        *name = line;
+        line = end + 4;
+
+        length = strlen(line);
+        if (length != 2 * SHA256_HASH_LENGTH || !parse_hash(line, hash))
+            return false;
+    }
+    else
+    {
+        length = 0;
+        while (hex_value(line[length]) >= 0)
+            ++length;
+
+        if (length != 2 * SHA256_HASH_LENGTH || !parse_hash(line, hash))
+            return false;
+
+        line += length;
+
+        if (*line != ' ' && *line != '\t')
+            return false;
+
+        ++line;
+
+        if (*line == ' ' || *line == '*')
+            ++line;
+
+        *name = line;
+    }
+
+    if (**name == '\0')
+        return false;
+
+    return !escaped || unescape_filename(*name);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static bool check_file(const char *checkfile)
+{
+    const bool from_stdin = (strcmp(checkfile, "-") == 0);
+    const char *display_name = from_stdin ? "standard input" : checkfile;
+
+    struct job_list list;
+    pthread_t *workers;
+    unsigned started;
+
+    size_t line_number = 0;
+    size_t properly_formatted = 0;
+    size_t misformatted = 0;
+    size_t read_failures = 0;
+    size_t mismatches = 0;
+    size_t matches = 0;
+
+    char *line = NULL;
+    size_t line_capacity = 0;
+    ssize_t line_length;
+
+    FILE *stream = from_stdin ? stdin : fopen(checkfile, "r");
+    if (!stream)
+    {
+        print_error(checkfile, errno);
+        return false;
+    }
+
+    job_list_init(&list);
+
+    while ((line_length = getdelim(&line, &line_capacity,
+                                   zero_terminated ? '\0' : '\n', stream)) > 0)
+    {
+        uint8_t hash[SHA256_HASH_LENGTH];
+        char *name;
+
+        ++line_number;
+
+        if (line[0] == '#')
+            continue;
+
+        if (line[line_length - 1] == (zero_terminated ? '\0' : '\n'))
+            line[--line_length] = '\0';
+
+        /* Check files written on DOS or Windows */
+        if (line_length > 0 && line[line_length - 1] == '\r')
+            line[--line_length] = '\0';
+
+        if (!parse_check_line(line, hash, &name))
+        {
+            ++misformatted;
+
+            /* Diagnostics are printed in order with the results */
+            if (warn)
+                job_list_add(&list, "")->misformatted_line = line_number;
+
+            continue;
+        }
+
+        memcpy(job_list_add(&list, name)->expected, hash, SHA256_HASH_LENGTH);
+        ++properly_formatted;
+    }
+
+    free(line);
+
+    if (ferror(stream))
+    {
+        fprintf(stderr, "%s: ", PROGRAM_NAME);
+        print_quoted(stderr, display_name);
+        fprintf(stderr, ": read error\n");
+
+        if (!from_stdin)
+            fclose(stream);
+
+        job_list_free(&list);
+        return false;
+    }
+
+    if (!from_stdin)
+        fclose(stream);
+
+    workers = job_list_start(&list, &started);
+
+    for (size_t i = 0; i < list.count; ++i)
+    {
+        const struct job *job = job_list_wait(&list, i);
+        /* Unlike when computing, coreutils escapes only names containing a newline here */
+        const bool escape = !status_only && strchr(job->name, '\n') != NULL;
+        bool ok;
+
+        if (job->misformatted_line)
+        {
+            fflush(stdout);
+            fprintf(stderr, "%s: ", PROGRAM_NAME);
+            print_quoted(stderr, display_name);
+            fprintf(stderr, ": %zu: improperly formatted SHA256 checksum line\n",
+                    job->misformatted_line);
+            continue;
+        }
+
+        if (job->error)
+        {
+            if (ignore_missing && job->error == ENOENT)
+                continue;
+
+            ++read_failures;
+            print_error(job->name, job->error);
+
+            if (!status_only)
+            {
+                if (escape)
+                    putchar('\\');
+
+                print_filename(job->name, escape);
+                fputs(": FAILED open or read\n", stdout);
+            }
+
+            continue;
+        }
+
+        ok = (memcmp(job->result.hash, job->expected, SHA256_HASH_LENGTH) == 0);
+
+        if (ok)
+            ++matches;
+        else
+            ++mismatches;
+
+        if (!status_only && (!ok || !quiet))
+        {
+            if (escape)
+                putchar('\\');
+
+            print_filename(job->name, escape);
+            fputs(ok ? ": OK\n" : ": FAILED\n", stdout);
+        }
+    }
+
+    job_list_join(workers, started);
+    job_list_free(&list);
+
+    fflush(stdout);
+
+    if (properly_formatted == 0)
+    {
+        fprintf(stderr, "%s: ", PROGRAM_NAME);
+        print_quoted(stderr, display_name);
+        fprintf(stderr, ": no properly formatted checksum lines found\n");
+        return false;
+    }
+
+    if (!status_only)
+    {
+        if (misformatted == 1)
+            fprintf(stderr, "%s: WARNING: 1 line is improperly formatted\n", PROGRAM_NAME);
+        else if (misformatted > 1)
+            fprintf(stderr, "%s: WARNING: %zu lines are improperly formatted\n",
+                    PROGRAM_NAME, misformatted);
+
+        if (read_failures == 1)
+            fprintf(stderr, "%s: WARNING: 1 listed file could not be read\n", PROGRAM_NAME);
+        else if (read_failures > 1)
+            fprintf(stderr, "%s: WARNING: %zu listed files could not be read\n",
+                    PROGRAM_NAME, read_failures);
+
+        if (mismatches == 1)
+            fprintf(stderr, "%s: WARNING: 1 computed checksum did NOT match\n", PROGRAM_NAME);
+        else if (mismatches > 1)
+            fprintf(stderr, "%s: WARNING: %zu computed checksums did NOT match\n",
+                    PROGRAM_NAME, mismatches);
+
+        if (ignore_missing && matches == 0 && mismatches == 0)
+        {
+            fprintf(stderr, "%s: ", PROGRAM_NAME);
+            print_quoted(stderr, display_name);
+            fprintf(stderr, ": no file was verified\n");
+        }
+    }
+
+    return mismatches == 0 && read_failures == 0 && (!strict || misformatted == 0) &&
+           (!ignore_missing || matches > 0 || mismatches > 0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void usage(int status)
+{
+    if (status != EXIT_SUCCESS)
+    {
+        fprintf(stderr, "Try '%s --help' for more information.\n", PROGRAM_NAME);
+        exit(status);
+    }
+
+    printf("Usage: %s [OPTION]... [FILE]...\n"
+           "Print or check SHA256 (256-bit) checksums.\n"
+           "\n"
+           "With no FILE, or when FILE is -, read standard input.\n"
+           "\n"
+           "  -b, --binary          read in binary mode\n"
+           "  -c, --check           read SHA256 sums from the FILEs and check them\n"
+           "      --tag             create a BSD-style checksum\n"
+           "  -t, --text            read in text mode (default)\n"
+           "  -z, --zero            end each output line with NUL, not newline,\n"
+           "                          and disable file name escaping\n"
+           "\n"
+           "The following five options are useful only when verifying checksums:\n"
+           "      --ignore-missing  don't fail or report status for missing files\n"
+           "      --quiet           don't print OK for each successfully verified file\n"
+           "      --status          don't output anything, status code shows success\n"
+           "      --strict          exit non-zero for improperly formatted checksum lines\n"
+           "  -w, --warn            warn about improperly formatted checksum lines\n"
+           "\n"
+           "      --threads=N       hash up to N files in parallel (default: one per CPU)\n"
+           "      --help            display this help and exit\n"
+           "      --version         output version information and exit\n",
+           PROGRAM_NAME);
+
+    exit(status);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void usage_error(const char *message)
+{
+    fprintf(stderr, "%s: %s\n", PROGRAM_NAME, message);
+    usage(EXIT_FAILURE);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+int main(int argc, char **argv)
+{
+    enum
+    {
+        OPTION_IGNORE_MISSING = 256,
+        OPTION_QUIET,
+        OPTION_STATUS,
+        OPTION_STRICT,
+        OPTION_TAG,
+        OPTION_THREADS,
+        OPTION_HELP,
+        OPTION_VERSION
+    };
+
+    static const struct option options[] =
+    {
+        { "binary",         no_argument,       NULL, 'b' },
+        { "check",          no_argument,       NULL, 'c' },
+        { "ignore-missing", no_argument,       NULL, OPTION_IGNORE_MISSING },
+        { "quiet",          no_argument,       NULL, OPTION_QUIET },
+        { "status",         no_argument,       NULL, OPTION_STATUS },
+        { "strict",         no_argument,       NULL, OPTION_STRICT },
+        { "tag",            no_argument,       NULL, OPTION_TAG },
+        { "text",           no_argument,       NULL, 't' },
+        { "threads",        required_argument, NULL, OPTION_THREADS },
+        { "warn",           no_argument,       NULL, 'w' },
+        { "zero",           no_argument,       NULL, 'z' },
+        { "help",           no_argument,       NULL, OPTION_HELP },
+        { "version",        no_argument,       NULL, OPTION_VERSION },
+        { NULL, 0, NULL, 0 }
+    };
+
+    static char *default_files[] = { "-" };
+
+    bool ok = true;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "bctwz", options, NULL)) != -1)
+    {
+        switch (c)
+        {
+        case 'b': binary_mode = true; binary_or_text = true; break;
+        case 'c': check_mode = true; break;
+        case 't': binary_mode = false; binary_or_text = true; break;
+        case 'w': warn = true; quiet = false; status_only = false; break;
+        case 'z': zero_terminated = true; break;
+
+        case OPTION_IGNORE_MISSING: ignore_missing = true; break;
+        case OPTION_QUIET: quiet = true; status_only = false; warn = false; break;
+        case OPTION_STATUS: status_only = true; quiet = false; warn = false; break;
+        case OPTION_STRICT: strict = true; break;
+        case OPTION_TAG: bsd_tag = true; binary_mode = true; break;
+
+        case OPTION_THREADS:
+            thread_count = (unsigned)strtoul(optarg, NULL, 10);
+            break;
+
+        case OPTION_HELP:
+            usage(EXIT_SUCCESS);
+            break;
+
+        case OPTION_VERSION:
+            printf("%s (ISF Utilities)\n", PROGRAM_NAME);
+            return EXIT_SUCCESS;
+
+        default:
+            usage(EXIT_FAILURE);
+        }
+    }
+
+    /* Same checks in the same order as coreutils, which names only the first offending option */
+    if (bsd_tag && !binary_mode)
+        usage_error("--tag does not support --text mode");
+
+    if (bsd_tag && check_mode)
+        usage_error("the --tag option is meaningless when verifying checksums");
+
+    if (binary_or_text && check_mode)
+        usage_error("the --binary and --text options are meaningless when verifying checksums");
+
+    if (ignore_missing && !check_mode)
+        usage_error("the --ignore-missing option is meaningful only when verifying checksums");
+
+    if (status_only && !check_mode)
+        usage_error("the --status option is meaningful only when verifying checksums");
+
+    if (warn && !check_mode)
+        usage_error("the --warn option is meaningful only when verifying checksums");
+
+    if (quiet && !check_mode)
+        usage_error("the --quiet option is meaningful only when verifying checksums");
+
+    if (strict && !check_mode)
+        usage_error("the --strict option is meaningful only when verifying checksums");
+
+    if (optind == argc)
+    {
+        argv = default_files;
+        argc = 1;
+        optind = 0;
+    }
+
+    if (check_mode)
+    {
+        for (int i = optind; i < argc; ++i)
+            ok &= check_file(argv[i]);
+    }
+    else
+        ok = compute_files(argv + optind, argc - optind);
+
+    if (fflush(stdout) != 0 || ferror(stdout))
+    {
+        fprintf(stderr, "%s: write error: %s\n", PROGRAM_NAME, strerror(errno));
+        return EXIT_FAILURE;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,41 @@
+# Round trip of file names that sha256sum has to escape, run by CTest with -DSHA256SUM=<path>.
+# Names containing a backslash, newline or carriage return are printed as "\<hash>  <name>" with
+# these characters escaped, and -c must accept exactly what was printed. Like coreutils, -c itself
+# escapes only names containing a newline.
+
+set(directory "${CMAKE_CURRENT_BINARY_DIR}/sha256sum_test")
+file(REMOVE_RECURSE "${directory}")
+file(MAKE_DIRECTORY "${directory}")
+
+foreach(name "carriage\rreturn" "line\nfeed" "back\\slash" "all\r\n\\three")
+    file(WRITE "${directory}/${name}" "${name}")
+    file(SHA256 "${directory}/${name}" hash)
+
+    string(REPLACE "\\" "\\\\" escaped "${name}")
+    string(REPLACE "\n" "\\n" escaped "${escaped}")
+    string(REPLACE "\r" "\\r" escaped "${escaped}")
+
+    execute_process(COMMAND "${SHA256SUM}" "${name}" WORKING_DIRECTORY "${directory}"
+                    OUTPUT_VARIABLE output RESULT_VARIABLE result)
+
+    if(NOT result EQUAL 0 OR NOT output STREQUAL "\\${hash}  ${escaped}\n")
+        message(FATAL_ERROR "Unexpected output for ${escaped}: ${output}")
+    endif()
+
+    file(WRITE "${directory}/check" "${output}")
+
+    execute_process(COMMAND "${SHA256SUM}" -c check WORKING_DIRECTORY "${directory}"
+                    OUTPUT_VARIABLE output ERROR_VARIABLE error RESULT_VARIABLE result)
+
+    if(name MATCHES "\n")
+        set(expected "\\${escaped}: OK\n")
+    else()
+        set(expected "${name}: OK\n")
+    endif()
+
+    if(NOT result EQUAL 0 OR NOT output STREQUAL expected OR error)
+        message(FATAL_ERROR "Check of ${escaped} failed: ${output}${error}")
+    endif()
+endforeach()
+
+file(REMOVE_RECURSE "${directory}")
@@ -0,0 +1,264 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "sha256tree.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SHA256_TREE_NO_THREADS
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------- //
+
+#define _SHA256_TREE_LEAF_PREFIX 0x00
+#define _SHA256_TREE_NODE_PREFIX 0x01
+
+/* Minimum amount of data claimed by a worker at once */
+#define _SHA256_TREE_BATCH_SIZE (1024 * 1024)
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void _sha256_tree_hash_node(const struct sha256_result *left,
+                                   const struct sha256_result *right,
+                                   struct sha256_result *result)
+{
+    const uint8_t prefix = _SHA256_TREE_NODE_PREFIX;
+
+    struct sha256_context ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, &prefix, 1);
+    sha256_update(&ctx, left->hash, SHA256_HASH_LENGTH);
+    sha256_update(&ctx, right->hash, SHA256_HASH_LENGTH);
+    sha256_finish(&ctx, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void _sha256_tree_hash_range(const struct sha256_result *leaves, size_t count,
+                                    struct sha256_result *result)
+{
+    struct sha256_result left, right;
+    size_t split = 1;
+
+    if (count == 1)
+    {
+        *result = leaves[0];
+        return;
+    }
+
+    /* Split at largest power of two smaller than count, recursion depth is log2(count) */
+    while (split * 2 < count)
+        split *= 2;
+
+    _sha256_tree_hash_range(leaves, split, &left);
+    _sha256_tree_hash_range(leaves + split, count - split, &right);
+    _sha256_tree_hash_node(&left, &right, result);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+size_t sha256_tree_leaf_count(size_t length, uint32_t leaf_size)
+{
+    if (length == 0)
+        return 1;
+
+    return (length - 1) / leaf_size + 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void sha256_tree_hash_leaves(const uint8_t *buffer, size_t length, uint32_t leaf_size,
+                             size_t first, size_t count, struct sha256_result *leaves)
+{
+    const uint8_t prefix = _SHA256_TREE_LEAF_PREFIX;
+    size_t i;
+
+    for (i = 0; i < count; ++i)
+    {
+        const size_t offset = (first + i) * leaf_size;
+        size_t size = 0;
+
+        struct sha256_context ctx;
+
+        if (offset < length)
+        {
+            size = length - offset;
+            if (size > leaf_size)
+                size = leaf_size;
+        }
+
+        sha256_init(&ctx);
+        sha256_update(&ctx, &prefix, 1);
+        sha256_update(&ctx, buffer + offset, size);
+        sha256_finish(&ctx, &leaves[i]);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void sha256_tree_root(const struct sha256_result *leaves, size_t count,
+                      struct sha256_result *root)
+{
+    if (count == 0)
+    {
+        sha256_compute(NULL, 0, root);
+        return;
+    }
+
+    _sha256_tree_hash_range(leaves, count, root);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+#ifndef SHA256_TREE_NO_THREADS
+
+struct _sha256_tree_job
+{
+    const uint8_t *buffer;
+    size_t length;
+    uint32_t leaf_size;
+    size_t leaf_count;
+    size_t batch;
+    struct sha256_result *leaves;
+    atomic_size_t next;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void *_sha256_tree_worker(void *arg)
+{
+    struct _sha256_tree_job *job = (struct _sha256_tree_job *)arg;
+
+    for (;;)
+    {
+        const size_t first = atomic_fetch_add(&job->next, job->batch);
+        size_t count = job->batch;
+
+        if (first >= job->leaf_count)
+            break;
+
+        if (count > job->leaf_count - first)
+            count = job->leaf_count - first;
+
+        sha256_tree_hash_leaves(job->buffer, job->length, job->leaf_size,
+                                first, count, job->leaves + first);
+    }
+
+    return NULL;
+}
+
+#endif /* SHA256_TREE_NO_THREADS */
+
+// ---------------------------------------------------------------------------------------------- //
+
+int sha256_tree_compute(const uint8_t *buffer, size_t length, uint32_t leaf_size,
+                        unsigned threads, struct sha256_result *leaves,
+                        struct sha256_result *root)
+{
+    struct sha256_result *storage = leaves;
+    size_t leaf_count;
+
+    if (leaf_size == 0)
+        return -1;
+
+    leaf_count = sha256_tree_leaf_count(length, leaf_size);
+
+    if (!storage)
+    {
+        storage = (struct sha256_result *)malloc(leaf_count * sizeof(struct sha256_result));
+        if (!storage)
+            return -1;
+    }
+
+#ifdef SHA256_TREE_NO_THREADS
+    (void)threads;
+    sha256_tree_hash_leaves(buffer, length, leaf_size, 0, leaf_count, storage);
+#else
+    {
+        struct _sha256_tree_job job;
+        pthread_t *workers = NULL;
+        unsigned started = 0;
+        unsigned i;
+
+        if (threads == 0)
+        {
+            const long online = sysconf(_SC_NPROCESSORS_ONLN);
+            threads = online > 0 ? (unsigned)online : 1;
+        }
+
+        if (threads > leaf_count)
+            threads = (unsigned)leaf_count;
+
+        job.buffer = buffer;
+        job.length = length;
+        job.leaf_size = leaf_size;
+        job.leaf_count = leaf_count;
+        job.batch = leaf_size < _SHA256_TREE_BATCH_SIZE ? _SHA256_TREE_BATCH_SIZE / leaf_size : 1;
+        job.leaves = storage;
+        atomic_init(&job.next, 0);
+
+        /* The calling thread takes part in the work. If creating a thread fails, the
+           remaining workers simply pick up its share. */
+        if (threads > 1)
+            workers = (pthread_t *)malloc((threads - 1) * sizeof(pthread_t));
+
+        if (workers)
+        {
+            for (i = 0; i < threads - 1; ++i)
+            {
+                if (pthread_create(&workers[started], NULL, _sha256_tree_worker, &job) == 0)
+                    ++started;
+            }
+        }
+
+        _sha256_tree_worker(&job);
+
+        for (i = 0; i < started; ++i)
+            pthread_join(workers[i], NULL);
+
+        free(workers);
+    }
+#endif
+
+    sha256_tree_root(storage, leaf_count, root);
+
+    if (storage != leaves)
+        free(storage);
+
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
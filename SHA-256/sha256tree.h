@@ -0,0 +1,78 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#ifndef ISF_SHA256_TREE_H
+#define ISF_SHA256_TREE_H
+
+#include "sha256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Merkle tree hashing for large buffers.
+ *
+ * The buffer is split into leaves of leaf_size bytes, the last leaf possibly being shorter. An
+ * empty buffer consists of a single empty leaf. The tree is built as specified in RFC 6962:
+ *
+ *   leaf hash = SHA-256(0x00 || leaf data)
+ *   node hash = SHA-256(0x01 || left child hash || right child hash)
+ *
+ * Leaves are paired level by level from the left. If a level has an odd number of nodes, the
+ * last one is promoted to the next level unchanged. The root is therefore different from the
+ * plain SHA-256 of the buffer. Leaf hashes can be kept by the caller in order to re-verify or
+ * resume transfers of individual ranges with sha256_tree_hash_leaves().
+ */
+
+#define SHA256_TREE_DEFAULT_LEAF_SIZE (1024 * 1024)
+
+size_t sha256_tree_leaf_count(size_t length, uint32_t leaf_size);
+
+void sha256_tree_hash_leaves(const uint8_t *buffer, size_t length, uint32_t leaf_size,
+                             size_t first, size_t count, struct sha256_result *leaves);
+
+void sha256_tree_root(const struct sha256_result *leaves, size_t count,
+                      struct sha256_result *root);
+
+/* Hashes all leaves using the given number of threads (0 = one per online processor) and
+   computes the root. The leaves array may be NULL if the leaf hashes are not needed, otherwise
+   it must hold sha256_tree_leaf_count() entries. Returns 0 on success or -1 on error. */
+int sha256_tree_compute(const uint8_t *buffer, size_t length, uint32_t leaf_size,
+                        unsigned threads, struct sha256_result *leaves,
+                        struct sha256_result *root);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* ISF_SHA256_TREE_H */
@@ -30,29 +30,295 @@
 //   POSSIBILITY OF SUCH DAMAGE.                                                                  //
 //                                                                                                //
 // ============================================================================================== //
-
-/* Test for SHA-256 library. Compare e.g. with output from 'echo -n "foobar" | sha256sum' */
+/* Test for SHA-256 library. Checks the example messages published by NIST for FIPS 180-4 and,
+   if their paths are given as arguments, the CAVP response files SHA256ShortMsg.rsp,
+   SHA256LongMsg.rsp and SHA256Monte.rsp from the SHA Validation System. */
 
 #include "sha256.h"
+#include "sha256tree.h"
 
+#include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------------------------- //
+
+#ifdef SHA256_SMALL_FOOTPRINT
+#define TRANSFORM_NAME "small footprint"
+#else
+#define TRANSFORM_NAME "default"
+#endif
+
+// ---------------------------------------------------------------------------------------------- //
+
+struct test_vector
+{
+    const char *message;
+    uint32_t repeat;
+    const char *digest;
+};
+
+static const struct test_vector vectors[] =
+{
+    { "", 1, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", 1, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqr"
+      "lmnopqrsmnopqrstnopqrstu", 1,
+      "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+    { "a", 1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+    /* 1 GiB, requires correct 64-bit message length */
+    { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno", 16777216,
+      "50e72a0e26442fe2552dc3938ac58658228c0cbfb1d2ca872ae435266fcd055e" }
+};
 
 // ---------------------------------------------------------------------------------------------- //
 
-static const uint8_t buffer[6] = { 'f', 'o', 'o', 'b', 'a', 'r' };
+static int passed = 0;
+static int failed = 0;
 
 // ---------------------------------------------------------------------------------------------- //
 
-int main()
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static size_t parse_hex(const char *text, uint8_t *output, size_t capacity)
+{
+    size_t length = 0;
+
+    while (length < capacity && hex_value(text[2*length]) >= 0 && hex_value(text[2*length + 1]) >= 0)
+    {
+        output[length] = (uint8_t)((hex_value(text[2*length]) << 4) | hex_value(text[2*length + 1]));
+        ++length;
+    }
+
+    return length;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void check(const char *name, const struct sha256_result *result, const uint8_t *expected)
+{
+    if (memcmp(result->hash, expected, SHA256_HASH_LENGTH) == 0)
+    {
+        ++passed;
+        return;
+    }
+
+    ++failed;
+    printf("FAILED: %s\n", name);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/* Hashes the message both in one piece and in irregular pieces via the incremental interface */
+static void check_message(const char *name, const uint8_t *message, size_t length,
+                          const uint8_t *expected)
 {
     struct sha256_result result;
-    sha256_compute(buffer, sizeof(buffer), &result);
+    struct sha256_context ctx;
+    size_t position = 0;
+    size_t step = 1;
+
+    sha256_compute(message, (uint32_t)length, &result);
+    check(name, &result, expected);
+
+    sha256_init(&ctx);
+
+    while (position < length)
+    {
+        const size_t count = step < length - position ? step : length - position;
+
+        sha256_update(&ctx, message + position, count);
+
+        position += count;
+        step = (step * 7 + 3) % 131;
+    }
+
+    sha256_finish(&ctx, &result);
+    check(name, &result, expected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void run_builtin_vectors(void)
+{
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); ++i)
+    {
+        const struct test_vector *vector = &vectors[i];
+        const size_t length = strlen(vector->message);
+
+        uint8_t expected[SHA256_HASH_LENGTH];
+        parse_hex(vector->digest, expected, sizeof(expected));
+
+        if (vector->repeat == 1)
+            check_message(vector->message, (const uint8_t *)vector->message, length, expected);
+        else
+        {
+            struct sha256_result result;
+            struct sha256_context ctx;
+
+            sha256_init(&ctx);
 
-    for (int i = 0; i < sizeof(result.hash); ++i)
-        printf("%02x", result.hash[i]);
+            for (uint32_t j = 0; j < vector->repeat; ++j)
+                sha256_update(&ctx, (const uint8_t *)vector->message, length);
 
-    printf("\n");
+            sha256_finish(&ctx, &result);
+            check(vector->message, &result, expected);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+/* Runs one checkpoint of the Monte Carlo test, see SHAVS section 6.4. The seed is replaced by
+   the resulting digest, which is the seed for the next checkpoint. */
+static void run_monte_carlo(uint8_t *seed, size_t count, const uint8_t *expected)
+{
+    uint8_t message[3 * SHA256_HASH_LENGTH];
+    struct sha256_result result;
+    char name[32];
+
+    memcpy(message + 0 * SHA256_HASH_LENGTH, seed, SHA256_HASH_LENGTH);
+    memcpy(message + 1 * SHA256_HASH_LENGTH, seed, SHA256_HASH_LENGTH);
+    memcpy(message + 2 * SHA256_HASH_LENGTH, seed, SHA256_HASH_LENGTH);
+
+    for (int i = 3; i < 1003; ++i)
+    {
+        sha256_compute(message, sizeof(message), &result);
+
+        memmove(message, message + SHA256_HASH_LENGTH, 2 * SHA256_HASH_LENGTH);
+        memcpy(message + 2 * SHA256_HASH_LENGTH, result.hash, SHA256_HASH_LENGTH);
+    }
+
+    memcpy(seed, result.hash, SHA256_HASH_LENGTH);
+
+    snprintf(name, sizeof(name), "Monte Carlo #%zu", count);
+    check(name, &result, expected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static int run_response_file(const char *path)
+{
+    /* The longest message in SHA256LongMsg.rsp has 51200 bits */
+    static char line[1 << 16];
+    static uint8_t message[1 << 15];
+
+    size_t bits = 0;
+
+    uint8_t seed[SHA256_HASH_LENGTH];
+    int has_seed = 0;
+    size_t count = 0;
+    size_t vectors = 0;
+
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        printf("Unable to open %s\n", path);
+        return -1;
+    }
+
+    while (fscanf(file, " %65535[^\n]", line) == 1)
+    {
+        uint8_t expected[SHA256_HASH_LENGTH];
+        char name[256];
+
+        if (strncmp(line, "Len = ", 6) == 0)
+            bits = strtoul(line + 6, NULL, 10);
+        else if (strncmp(line, "Msg = ", 6) == 0)
+            parse_hex(line + 6, message, sizeof(message));
+        else if (strncmp(line, "Seed = ", 7) == 0)
+        {
+            parse_hex(line + 7, seed, sizeof(seed));
+            has_seed = 1;
+        }
+        else if (strncmp(line, "COUNT = ", 8) == 0)
+            count = strtoul(line + 8, NULL, 10);
+        else if (strncmp(line, "MD = ", 5) == 0)
+        {
+            parse_hex(line + 5, expected, sizeof(expected));
+
+            if (has_seed)
+                run_monte_carlo(seed, count, expected);
+            else
+            {
+                snprintf(name, sizeof(name), "%s (Len = %zu)", path, bits);
+                check_message(name, message, bits / 8, expected);
+            }
+
+            ++vectors;
+        }
+    }
+
+    fclose(file);
+
+    printf("%s: %zu vectors\n", path, vectors);
     return 0;
-};
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void run_tree_test(void)
+{
+    /* Root computed independently from the RFC 6962 definition */
+    static const char *const expected_root =
+        "9a58adf6fd86c4a645c2fb6fd865d877ccd215f9e5dc909d012e8644e1f08bc9";
+
+    static uint8_t buffer[100000];
+
+    struct sha256_result leaves[25];
+    struct sha256_result root, root_threaded;
+    uint8_t expected[SHA256_HASH_LENGTH];
+
+    for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = (uint8_t)i;
+
+    assert(sha256_tree_leaf_count(sizeof(buffer), 4096) == 25);
+
+    parse_hex(expected_root, expected, sizeof(expected));
+
+    sha256_tree_hash_leaves(buffer, sizeof(buffer), 4096, 0, 25, leaves);
+    sha256_tree_root(leaves, 25, &root);
+    check("Merkle tree", &root, expected);
+
+    /* Tree hash must not depend on number of threads used */
+    sha256_tree_compute(buffer, sizeof(buffer), 4096, 4, NULL, &root_threaded);
+    check("Merkle tree (threaded)", &root_threaded, expected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+int main(int argc, char **argv)
+{
+    printf("Testing %s transform\n", TRANSFORM_NAME);
+
+    run_builtin_vectors();
+    run_tree_test();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (run_response_file(argv[i]) != 0)
+            ++failed;
+    }
+
+    printf("%d passed, %d failed\n", passed, failed);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
 // ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,677 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "convolutionkernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SINCFILTER_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    using KernelFunction = void (*)(const double*, const double*, size_t, double*, size_t);
+    using FloatFunction = void (*)(const float*, const float*, size_t, float*, size_t);
+    using ChannelsFunction = void (*)(const double*, size_t, const double*, size_t, double*,
+                                      size_t, size_t, size_t);
+
+    struct Kernel
+    {
+        KernelFunction function;
+        KernelFunction symmetric;
+        ChannelsFunction channels;
+        FloatFunction single;
+        const char* name;
+        double speedup;
+    };
+
+    // Four independent outputs per iteration allow the compiler to vectorize
+    template <typename T>
+    void correlateGeneric(const T* input, const T* reversed, size_t taps, T* output, size_t count)
+    {
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            T a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const T c = reversed[k];
+                const T* x = input + i + k;
+
+                a0 += x[0] * c;
+                a1 += x[1] * c;
+                a2 += x[2] * c;
+                a3 += x[3] * c;
+            }
+
+            output[i + 0] = a0;
+            output[i + 1] = a1;
+            output[i + 2] = a2;
+            output[i + 3] = a3;
+        }
+
+        for (; i < count; ++i)
+        {
+            T a = 0;
+
+            for (size_t k = 0; k < taps; ++k)
+                a += input[i + k] * reversed[k];
+
+            output[i] = a;
+        }
+    }
+
+    // Mirrored samples are added first, so each coefficient pair costs a single multiplication
+    void correlateSymmetricGeneric(const double* input, const double* half, size_t taps,
+                                   double* output, size_t count)
+    {
+        const size_t center = taps / 2;
+
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            double a0 = 0.0, a1 = 0.0, a2 = 0.0, a3 = 0.0;
+
+            for (size_t k = 0; k < center; ++k)
+            {
+                const double c = half[k];
+                const double* x = input + i + k;
+                const double* y = input + i + taps - 1 - k;
+
+                a0 += (x[0] + y[0]) * c;
+                a1 += (x[1] + y[1]) * c;
+                a2 += (x[2] + y[2]) * c;
+                a3 += (x[3] + y[3]) * c;
+            }
+
+            const double c = half[center];
+            const double* x = input + i + center;
+
+            output[i + 0] = a0 + x[0] * c;
+            output[i + 1] = a1 + x[1] * c;
+            output[i + 2] = a2 + x[2] * c;
+            output[i + 3] = a3 + x[3] * c;
+        }
+
+        for (; i < count; ++i)
+        {
+            double a = 0.0;
+
+            for (size_t k = 0; k < center; ++k)
+                a += (input[i + k] + input[i + taps - 1 - k]) * half[k];
+
+            output[i] = a + input[i + center] * half[center];
+        }
+    }
+
+    // Channels are the innermost loop, which the compiler vectorizes
+    void correlateChannelsGeneric(const double* input, size_t inputStride,
+                                  const double* reversed, size_t taps, double* output,
+                                  size_t outputStride, size_t count, size_t channels)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            double* y = output + i * outputStride;
+            std::fill_n(y, channels, 0.0);
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const double c = reversed[k];
+                const double* x = input + (i + k) * inputStride;
+
+                for (size_t j = 0; j < channels; ++j)
+                    y[j] += x[j] * c;
+            }
+        }
+    }
+
+#ifdef SINCFILTER_X86_DISPATCH
+
+    // Register blocking: 4 accumulators of 4 outputs each, every coefficient is loaded once for
+    // 16 outputs. The remaining outputs use scalar FMA to produce bit-identical results.
+    __attribute__((target("avx2,fma")))
+    void correlateAvx2(const double* input, const double* reversed, size_t taps,
+                       double* output, size_t count)
+    {
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256d a0 = _mm256_setzero_pd();
+            __m256d a1 = _mm256_setzero_pd();
+            __m256d a2 = _mm256_setzero_pd();
+            __m256d a3 = _mm256_setzero_pd();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m256d c = _mm256_broadcast_sd(reversed + k);
+                const double* x = input + i + k;
+
+                a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x +  0), c, a0);
+                a1 = _mm256_fmadd_pd(_mm256_loadu_pd(x +  4), c, a1);
+                a2 = _mm256_fmadd_pd(_mm256_loadu_pd(x +  8), c, a2);
+                a3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + 12), c, a3);
+            }
+
+            _mm256_storeu_pd(output + i +  0, a0);
+            _mm256_storeu_pd(output + i +  4, a1);
+            _mm256_storeu_pd(output + i +  8, a2);
+            _mm256_storeu_pd(output + i + 12, a3);
+        }
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256d a = _mm256_setzero_pd();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m256d x = _mm256_loadu_pd(input + i + k);
+                a = _mm256_fmadd_pd(x, _mm256_broadcast_sd(reversed + k), a);
+            }
+
+            _mm256_storeu_pd(output + i, a);
+        }
+
+        for (; i < count; ++i)
+        {
+            double a = 0.0;
+
+            for (size_t k = 0; k < taps; ++k)
+                a = __builtin_fma(input[i + k], reversed[k], a);
+
+            output[i] = a;
+        }
+    }
+
+    // Symmetric variant of the AVX2 kernel, the center tap is accumulated last
+    __attribute__((target("avx2,fma")))
+    void correlateSymmetricAvx2(const double* input, const double* half, size_t taps,
+                                double* output, size_t count)
+    {
+        const size_t center = taps / 2;
+
+        size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256d a0 = _mm256_setzero_pd();
+            __m256d a1 = _mm256_setzero_pd();
+            __m256d a2 = _mm256_setzero_pd();
+            __m256d a3 = _mm256_setzero_pd();
+
+            for (size_t k = 0; k < center; ++k)
+            {
+                const __m256d c = _mm256_broadcast_sd(half + k);
+                const double* x = input + i + k;
+                const double* y = input + i + taps - 1 - k;
+
+                a0 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x +  0),
+                                                   _mm256_loadu_pd(y +  0)), c, a0);
+                a1 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x +  4),
+                                                   _mm256_loadu_pd(y +  4)), c, a1);
+                a2 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x +  8),
+                                                   _mm256_loadu_pd(y +  8)), c, a2);
+                a3 = _mm256_fmadd_pd(_mm256_add_pd(_mm256_loadu_pd(x + 12),
+                                                   _mm256_loadu_pd(y + 12)), c, a3);
+            }
+
+            const __m256d c = _mm256_broadcast_sd(half + center);
+            const double* x = input + i + center;
+
+            _mm256_storeu_pd(output + i +  0, _mm256_fmadd_pd(_mm256_loadu_pd(x +  0), c, a0));
+            _mm256_storeu_pd(output + i +  4, _mm256_fmadd_pd(_mm256_loadu_pd(x +  4), c, a1));
+            _mm256_storeu_pd(output + i +  8, _mm256_fmadd_pd(_mm256_loadu_pd(x +  8), c, a2));
+            _mm256_storeu_pd(output + i + 12, _mm256_fmadd_pd(_mm256_loadu_pd(x + 12), c, a3));
+        }
+
+        for (; i < count; ++i)
+        {
+            double a = 0.0;
+
+            for (size_t k = 0; k < center; ++k)
+                a = __builtin_fma(input[i + k] + input[i + taps - 1 - k], half[k], a);
+
+            output[i] = __builtin_fma(input[i + center], half[center], a);
+        }
+    }
+
+    // Register blocking over 4 frames of 4 channels each, every coefficient is loaded once for
+    // 16 outputs. Remaining channels use scalar FMA.
+    __attribute__((target("avx2,fma")))
+    void correlateChannelsAvx2(const double* input, size_t inputStride,
+                               const double* reversed, size_t taps, double* output,
+                               size_t outputStride, size_t count, size_t channels)
+    {
+        size_t j = 0;
+
+        for (; j + 4 <= channels; j += 4)
+        {
+            size_t i = 0;
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m256d a0 = _mm256_setzero_pd();
+                __m256d a1 = _mm256_setzero_pd();
+                __m256d a2 = _mm256_setzero_pd();
+                __m256d a3 = _mm256_setzero_pd();
+
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    const __m256d c = _mm256_broadcast_sd(reversed + k);
+                    const double* x = input + (i + k) * inputStride + j;
+
+                    a0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + 0 * inputStride), c, a0);
+                    a1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + 1 * inputStride), c, a1);
+                    a2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + 2 * inputStride), c, a2);
+                    a3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + 3 * inputStride), c, a3);
+                }
+
+                double* y = output + i * outputStride + j;
+
+                _mm256_storeu_pd(y + 0 * outputStride, a0);
+                _mm256_storeu_pd(y + 1 * outputStride, a1);
+                _mm256_storeu_pd(y + 2 * outputStride, a2);
+                _mm256_storeu_pd(y + 3 * outputStride, a3);
+            }
+
+            for (; i < count; ++i)
+            {
+                __m256d a = _mm256_setzero_pd();
+
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    const __m256d x = _mm256_loadu_pd(input + (i + k) * inputStride + j);
+                    a = _mm256_fmadd_pd(x, _mm256_broadcast_sd(reversed + k), a);
+                }
+
+                _mm256_storeu_pd(output + i * outputStride + j, a);
+            }
+        }
+
+        for (; j < channels; ++j)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                double a = 0.0;
+
+                for (size_t k = 0; k < taps; ++k)
+                    a = __builtin_fma(input[(i + k) * inputStride + j], reversed[k], a);
+
+                output[i * outputStride + j] = a;
+            }
+        }
+    }
+
+    // Single precision variant of the AVX2 kernel with 8 outputs per register
+    __attribute__((target("avx2,fma")))
+    void correlateFloatAvx2(const float* input, const float* reversed, size_t taps,
+                            float* output, size_t count)
+    {
+        size_t i = 0;
+
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256 a0 = _mm256_setzero_ps();
+            __m256 a1 = _mm256_setzero_ps();
+            __m256 a2 = _mm256_setzero_ps();
+            __m256 a3 = _mm256_setzero_ps();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m256 c = _mm256_broadcast_ss(reversed + k);
+                const float* x = input + i + k;
+
+                a0 = _mm256_fmadd_ps(_mm256_loadu_ps(x +  0), c, a0);
+                a1 = _mm256_fmadd_ps(_mm256_loadu_ps(x +  8), c, a1);
+                a2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + 16), c, a2);
+                a3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + 24), c, a3);
+            }
+
+            _mm256_storeu_ps(output + i +  0, a0);
+            _mm256_storeu_ps(output + i +  8, a1);
+            _mm256_storeu_ps(output + i + 16, a2);
+            _mm256_storeu_ps(output + i + 24, a3);
+        }
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 a = _mm256_setzero_ps();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m256 x = _mm256_loadu_ps(input + i + k);
+                a = _mm256_fmadd_ps(x, _mm256_broadcast_ss(reversed + k), a);
+            }
+
+            _mm256_storeu_ps(output + i, a);
+        }
+
+        for (; i < count; ++i)
+        {
+            float a = 0.0f;
+
+            for (size_t k = 0; k < taps; ++k)
+                a = __builtin_fmaf(input[i + k], reversed[k], a);
+
+            output[i] = a;
+        }
+    }
+
+    // Same scheme with 8 outputs per register, remaining outputs use masked loads and stores
+    __attribute__((target("avx512f")))
+    void correlateAvx512(const double* input, const double* reversed, size_t taps,
+                         double* output, size_t count)
+    {
+        size_t i = 0;
+
+        for (; i + 32 <= count; i += 32)
+        {
+            __m512d a0 = _mm512_setzero_pd();
+            __m512d a1 = _mm512_setzero_pd();
+            __m512d a2 = _mm512_setzero_pd();
+            __m512d a3 = _mm512_setzero_pd();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m512d c = _mm512_set1_pd(reversed[k]);
+                const double* x = input + i + k;
+
+                a0 = _mm512_fmadd_pd(_mm512_loadu_pd(x +  0), c, a0);
+                a1 = _mm512_fmadd_pd(_mm512_loadu_pd(x +  8), c, a1);
+                a2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + 16), c, a2);
+                a3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + 24), c, a3);
+            }
+
+            _mm512_storeu_pd(output + i +  0, a0);
+            _mm512_storeu_pd(output + i +  8, a1);
+            _mm512_storeu_pd(output + i + 16, a2);
+            _mm512_storeu_pd(output + i + 24, a3);
+        }
+
+        for (; i < count; i += 8)
+        {
+            const __mmask8 mask = count - i >= 8 ? 0xff
+                                                 : static_cast<__mmask8>((1u << (count - i)) - 1);
+            __m512d a = _mm512_setzero_pd();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m512d x = _mm512_maskz_loadu_pd(mask, input + i + k);
+                a = _mm512_fmadd_pd(x, _mm512_set1_pd(reversed[k]), a);
+            }
+
+            _mm512_mask_storeu_pd(output + i, mask, a);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void correlateSymmetricAvx512(const double* input, const double* half, size_t taps,
+                                  double* output, size_t count)
+    {
+        const size_t center = taps / 2;
+
+        size_t i = 0;
+
+        for (; i + 32 <= count; i += 32)
+        {
+            __m512d a0 = _mm512_setzero_pd();
+            __m512d a1 = _mm512_setzero_pd();
+            __m512d a2 = _mm512_setzero_pd();
+            __m512d a3 = _mm512_setzero_pd();
+
+            for (size_t k = 0; k < center; ++k)
+            {
+                const __m512d c = _mm512_set1_pd(half[k]);
+                const double* x = input + i + k;
+                const double* y = input + i + taps - 1 - k;
+
+                a0 = _mm512_fmadd_pd(_mm512_add_pd(_mm512_loadu_pd(x +  0),
+                                                   _mm512_loadu_pd(y +  0)), c, a0);
+                a1 = _mm512_fmadd_pd(_mm512_add_pd(_mm512_loadu_pd(x +  8),
+                                                   _mm512_loadu_pd(y +  8)), c, a1);
+                a2 = _mm512_fmadd_pd(_mm512_add_pd(_mm512_loadu_pd(x + 16),
+                                                   _mm512_loadu_pd(y + 16)), c, a2);
+                a3 = _mm512_fmadd_pd(_mm512_add_pd(_mm512_loadu_pd(x + 24),
+                                                   _mm512_loadu_pd(y + 24)), c, a3);
+            }
+
+            const __m512d c = _mm512_set1_pd(half[center]);
+            const double* x = input + i + center;
+
+            _mm512_storeu_pd(output + i +  0, _mm512_fmadd_pd(_mm512_loadu_pd(x +  0), c, a0));
+            _mm512_storeu_pd(output + i +  8, _mm512_fmadd_pd(_mm512_loadu_pd(x +  8), c, a1));
+            _mm512_storeu_pd(output + i + 16, _mm512_fmadd_pd(_mm512_loadu_pd(x + 16), c, a2));
+            _mm512_storeu_pd(output + i + 24, _mm512_fmadd_pd(_mm512_loadu_pd(x + 24), c, a3));
+        }
+
+        for (; i < count; i += 8)
+        {
+            const __mmask8 mask = count - i >= 8 ? 0xff
+                                                 : static_cast<__mmask8>((1u << (count - i)) - 1);
+            __m512d a = _mm512_setzero_pd();
+
+            for (size_t k = 0; k < center; ++k)
+            {
+                const __m512d x = _mm512_maskz_loadu_pd(mask, input + i + k);
+                const __m512d y = _mm512_maskz_loadu_pd(mask, input + i + taps - 1 - k);
+                a = _mm512_fmadd_pd(_mm512_add_pd(x, y), _mm512_set1_pd(half[k]), a);
+            }
+
+            const __m512d x = _mm512_maskz_loadu_pd(mask, input + i + center);
+            a = _mm512_fmadd_pd(x, _mm512_set1_pd(half[center]), a);
+
+            _mm512_mask_storeu_pd(output + i, mask, a);
+        }
+    }
+
+    // Same scheme with 8 channels per register, remaining channels use masked loads and stores
+    __attribute__((target("avx512f")))
+    void correlateChannelsAvx512(const double* input, size_t inputStride,
+                                 const double* reversed, size_t taps, double* output,
+                                 size_t outputStride, size_t count, size_t channels)
+    {
+        for (size_t j = 0; j < channels; j += 8)
+        {
+            const __mmask8 mask = channels - j >= 8
+                                ? 0xff : static_cast<__mmask8>((1u << (channels - j)) - 1);
+            size_t i = 0;
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m512d a0 = _mm512_setzero_pd();
+                __m512d a1 = _mm512_setzero_pd();
+                __m512d a2 = _mm512_setzero_pd();
+                __m512d a3 = _mm512_setzero_pd();
+
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    const __m512d c = _mm512_set1_pd(reversed[k]);
+                    const double* x = input + (i + k) * inputStride + j;
+
+                    a0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + 0 * inputStride), c, a0);
+                    a1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + 1 * inputStride), c, a1);
+                    a2 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + 2 * inputStride), c, a2);
+                    a3 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + 3 * inputStride), c, a3);
+                }
+
+                double* y = output + i * outputStride + j;
+
+                _mm512_mask_storeu_pd(y + 0 * outputStride, mask, a0);
+                _mm512_mask_storeu_pd(y + 1 * outputStride, mask, a1);
+                _mm512_mask_storeu_pd(y + 2 * outputStride, mask, a2);
+                _mm512_mask_storeu_pd(y + 3 * outputStride, mask, a3);
+            }
+
+            for (; i < count; ++i)
+            {
+                __m512d a = _mm512_setzero_pd();
+
+                for (size_t k = 0; k < taps; ++k)
+                {
+                    const double* x = input + (i + k) * inputStride + j;
+                    a = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x), _mm512_set1_pd(reversed[k]),
+                                        a);
+                }
+
+                _mm512_mask_storeu_pd(output + i * outputStride + j, mask, a);
+            }
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void correlateFloatAvx512(const float* input, const float* reversed, size_t taps,
+                              float* output, size_t count)
+    {
+        size_t i = 0;
+
+        for (; i + 64 <= count; i += 64)
+        {
+            __m512 a0 = _mm512_setzero_ps();
+            __m512 a1 = _mm512_setzero_ps();
+            __m512 a2 = _mm512_setzero_ps();
+            __m512 a3 = _mm512_setzero_ps();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m512 c = _mm512_set1_ps(reversed[k]);
+                const float* x = input + i + k;
+
+                a0 = _mm512_fmadd_ps(_mm512_loadu_ps(x +  0), c, a0);
+                a1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + 16), c, a1);
+                a2 = _mm512_fmadd_ps(_mm512_loadu_ps(x + 32), c, a2);
+                a3 = _mm512_fmadd_ps(_mm512_loadu_ps(x + 48), c, a3);
+            }
+
+            _mm512_storeu_ps(output + i +  0, a0);
+            _mm512_storeu_ps(output + i + 16, a1);
+            _mm512_storeu_ps(output + i + 32, a2);
+            _mm512_storeu_ps(output + i + 48, a3);
+        }
+
+        for (; i < count; i += 16)
+        {
+            const __mmask16 mask = count - i >= 16
+                                 ? 0xffff : static_cast<__mmask16>((1u << (count - i)) - 1);
+            __m512 a = _mm512_setzero_ps();
+
+            for (size_t k = 0; k < taps; ++k)
+            {
+                const __m512 x = _mm512_maskz_loadu_ps(mask, input + i + k);
+                a = _mm512_fmadd_ps(x, _mm512_set1_ps(reversed[k]), a);
+            }
+
+            _mm512_mask_storeu_ps(output + i, mask, a);
+        }
+    }
+
+#endif // SINCFILTER_X86_DISPATCH
+
+    auto selectKernel() -> Kernel
+    {
+#ifdef SINCFILTER_X86_DISPATCH
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f"))
+            return { correlateAvx512, correlateSymmetricAvx512, correlateChannelsAvx512,
+                     correlateFloatAvx512, "AVX-512", 6.0 };
+
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return { correlateAvx2, correlateSymmetricAvx2, correlateChannelsAvx2,
+                     correlateFloatAvx2, "AVX2", 4.0 };
+#endif
+        return { correlateGeneric<double>, correlateSymmetricGeneric, correlateChannelsGeneric,
+                 correlateGeneric<float>, "Generic", 1.0 };
+    }
+
+    auto selectedKernel() -> const Kernel&
+    {
+        static const Kernel kernel = selectKernel();
+        return kernel;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ConvolutionKernel::correlate(const double* input, const double* reversed, size_t taps,
+                                  double* output, size_t count)
+{
+    selectedKernel().function(input, reversed, taps, output, count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ConvolutionKernel::correlate(const float* input, const float* reversed, size_t taps,
+                                  float* output, size_t count)
+{
+    selectedKernel().single(input, reversed, taps, output, count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ConvolutionKernel::correlateSymmetric(const double* input, const double* half, size_t taps,
+                                           double* output, size_t count)
+{
+    selectedKernel().symmetric(input, half, taps, output, count);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ConvolutionKernel::correlateChannels(const double* input, size_t inputStride,
+                                          const double* reversed, size_t taps, double* output,
+                                          size_t outputStride, size_t count, size_t channels)
+{
+    selectedKernel().channels(input, inputStride, reversed, taps, output, outputStride, count,
+                              channels);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto ConvolutionKernel::instructionSet() -> const char*
+{
+    return selectedKernel().name;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto ConvolutionKernel::speedup() -> double
+{
+    return selectedKernel().speedup;
+}
+
+// ---------------------------------------------------------------------------------------------- //
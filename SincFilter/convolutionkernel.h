@@ -0,0 +1,70 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include <cstddef>
+
+// Output-stationary direct convolution kernels. The implementation is selected at runtime
+// depending on the instruction sets supported by the processor (AVX-512, AVX2 with FMA or
+// generic code). Each output sample is accumulated in the same order by all code paths of an
+// implementation, so results do not depend on how the output range is split up.
+class ConvolutionKernel
+{
+public:
+    // Computes output[i] = sum(input[i + k] * reversed[k]) for k < taps and i < count, where
+    // reversed holds the filter coefficients in reverse order. Input must hold count + taps - 1
+    // samples.
+    static void correlate(const double* input, const double* reversed, size_t taps,
+                          double* output, size_t count);
+
+    // Single precision variant, processing twice as many outputs per register
+    static void correlate(const float* input, const float* reversed, size_t taps,
+                          float* output, size_t count);
+
+    // Same for an odd number of taps with symmetric coefficients, half holds the first
+    // taps / 2 + 1 of them. Mirrored input samples are added before the multiplication.
+    static void correlateSymmetric(const double* input, const double* half, size_t taps,
+                                   double* output, size_t count);
+
+    // Same for several interleaved channels, output[i * outputStride + j] is computed from
+    // input[(i + k) * inputStride + j] for j < channels. Each coefficient is applied to all
+    // channels of a frame.
+    static void correlateChannels(const double* input, size_t inputStride,
+                                  const double* reversed, size_t taps, double* output,
+                                  size_t outputStride, size_t count, size_t channels);
+
+    static auto instructionSet() -> const char*;
+
+    // Approximate speed of the selected implementation relative to the generic code
+    static auto speedup() -> double;
+};
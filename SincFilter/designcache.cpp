@@ -0,0 +1,200 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "designcache.h"
+
+#include <cassert>
+#include <functional>
+
+// ---------------------------------------------------------------------------------------------- //
+
+DesignCache::DesignCache(size_t capacity)
+    : m_capacity(capacity)
+{
+    assert(capacity > 0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::capacity() const -> size_t
+{
+    return m_capacity;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::size() const -> size_t
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::statistics() const -> Statistics
+{
+    std::lock_guard lock(m_mutex);
+    return m_statistics;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void DesignCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+
+    m_index.clear();
+    m_entries.clear();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::design(Type type, size_t size, double fl, double fh, Window window)
+    -> std::shared_ptr<const SincFilter>
+{
+    if (type == Type::LowPass || type == Type::HighPass)
+        fh = 0.0;
+
+    const Key key = { type, size, fl, fh, window };
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (auto it = m_index.find(key); it != m_index.end())
+        {
+            ++m_statistics.hits;
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+            return it->second->second;
+        }
+
+        ++m_statistics.misses;
+    }
+
+    // Designed without holding the lock, so other threads are not blocked meanwhile
+    auto filter = create(key);
+
+    std::lock_guard lock(m_mutex);
+
+    // Another thread may have inserted the same design in the meantime
+    if (auto it = m_index.find(key); it != m_index.end())
+        return it->second->second;
+
+    m_entries.emplace_front(key, filter);
+    m_index.emplace(key, m_entries.begin());
+
+    if (m_entries.size() > m_capacity)
+    {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+
+        ++m_statistics.evictions;
+    }
+
+    return filter;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::lowPass(size_t size, double fc, Window window)
+    -> std::shared_ptr<const SincFilter>
+{
+    return design(Type::LowPass, size, fc, 0.0, window);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::highPass(size_t size, double fc, Window window)
+    -> std::shared_ptr<const SincFilter>
+{
+    return design(Type::HighPass, size, fc, 0.0, window);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::stopBand(size_t size, double fl, double fh, Window window)
+    -> std::shared_ptr<const SincFilter>
+{
+    return design(Type::StopBand, size, fl, fh, window);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::bandPass(size_t size, double fl, double fh, Window window)
+    -> std::shared_ptr<const SincFilter>
+{
+    return design(Type::BandPass, size, fl, fh, window);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::KeyHash::operator()(const Key& key) const -> size_t
+{
+    size_t hash = std::hash<size_t>()(key.size);
+
+    const auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2);
+    };
+
+    combine(static_cast<size_t>(key.type));
+    combine(std::hash<double>()(key.fl));
+    combine(std::hash<double>()(key.fh));
+    combine(static_cast<size_t>(key.window.type));
+    combine(std::hash<double>()(key.window.beta));
+
+    return hash;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto DesignCache::create(const Key& key) -> std::shared_ptr<const SincFilter>
+{
+    switch (key.type)
+    {
+    case Type::LowPass:
+        return std::make_shared<const SincFilter>(SincFilter::lowPass(key.size, key.fl,
+                                                                      key.window));
+    case Type::HighPass:
+        return std::make_shared<const SincFilter>(SincFilter::highPass(key.size, key.fl,
+                                                                       key.window));
+    case Type::StopBand:
+        return std::make_shared<const SincFilter>(SincFilter::stopBand(key.size, key.fl, key.fh,
+                                                                       key.window));
+    case Type::BandPass:
+        return std::make_shared<const SincFilter>(SincFilter::bandPass(key.size, key.fl, key.fh,
+                                                                       key.window));
+    }
+
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------- //
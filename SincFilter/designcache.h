@@ -0,0 +1,125 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include "sincfilter.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Thread-safe cache of filter designs. Designs are shared as immutable, reference-counted
+// filters, so a cached design stays valid for its users after it has been evicted. When the
+// capacity is exceeded, the least recently used design is evicted.
+class DesignCache
+{
+public:
+    static constexpr size_t DefaultCapacity = 64;
+
+    using Window = SincFilter::Window;
+
+    enum class Type
+    {
+        LowPass,
+        HighPass,
+        StopBand,
+        BandPass
+    };
+
+    struct Statistics
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+public:
+    explicit DesignCache(size_t capacity = DefaultCapacity);
+
+    auto capacity() const -> size_t;
+    auto size() const -> size_t;
+    auto statistics() const -> Statistics;
+
+    void clear();
+
+    // Frequencies not used by a type are ignored, fh for low- and high-pass filters
+    auto design(Type type, size_t size, double fl, double fh, Window window)
+        -> std::shared_ptr<const SincFilter>;
+
+    auto lowPass(size_t size, double fc, Window window = SincFilter::DefaultWindowType)
+        -> std::shared_ptr<const SincFilter>;
+
+    auto highPass(size_t size, double fc, Window window = SincFilter::DefaultWindowType)
+        -> std::shared_ptr<const SincFilter>;
+
+    auto stopBand(size_t size, double fl, double fh,
+                  Window window = SincFilter::DefaultWindowType)
+        -> std::shared_ptr<const SincFilter>;
+
+    auto bandPass(size_t size, double fl, double fh,
+                  Window window = SincFilter::DefaultWindowType)
+        -> std::shared_ptr<const SincFilter>;
+
+private:
+    struct Key
+    {
+        Type type;
+        size_t size;
+        double fl;
+        double fh;
+        Window window;
+
+        auto operator==(const Key&) const -> bool = default;
+    };
+
+    struct KeyHash
+    {
+        auto operator()(const Key& key) const -> size_t;
+    };
+
+    using Entry = std::pair<Key, std::shared_ptr<const SincFilter>>;
+
+    static auto create(const Key& key) -> std::shared_ptr<const SincFilter>;
+
+private:
+    size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+
+    // Most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+
+    Statistics m_statistics;
+};
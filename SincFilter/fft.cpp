@@ -0,0 +1,136 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "fft.h"
+
+#include <bit>
+#include <cassert>
+#include <cmath>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    constexpr double TwoPi = 2.0 * 3.14159265358979323846;
+
+    // Plain complex multiplication, std::complex checks for infinities and NaNs
+    inline auto multiply(const Fft::Complex& a, const Fft::Complex& b) -> Fft::Complex
+    {
+        return { a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real() };
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+Fft::Fft(size_t size)
+    : m_twiddles(size / 2),
+      m_bitReversal(size)
+{
+    assert(size >= 2 && std::has_single_bit(size));
+
+    for (size_t i = 0; i < m_twiddles.size(); ++i)
+        m_twiddles[i] = std::polar(1.0, -TwoPi * static_cast<double>(i) / size);
+
+    const int bits = std::countr_zero(size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        size_t reversed = 0;
+
+        for (int b = 0; b < bits; ++b)
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+
+        m_bitReversal[i] = reversed;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto Fft::size() const -> size_t
+{
+    return m_bitReversal.size();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Fft::forward(std::span<Complex> data) const
+{
+    transform(data, false);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Fft::inverse(std::span<Complex> data) const
+{
+    transform(data, true);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void Fft::transform(std::span<Complex> data, bool inverse) const
+{
+    const size_t size = m_bitReversal.size();
+    assert(data.size() == size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const size_t j = m_bitReversal[i];
+
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    // Iterative radix-2 decimation in time
+    for (size_t length = 2; length <= size; length *= 2)
+    {
+        const size_t half = length / 2;
+        const size_t step = size / length;
+
+        for (size_t start = 0; start < size; start += length)
+        {
+            for (size_t k = 0; k < half; ++k)
+            {
+                Complex twiddle = m_twiddles[k * step];
+
+                if (inverse)
+                    twiddle = std::conj(twiddle);
+
+                const Complex even = data[start + k];
+                const Complex odd = multiply(data[start + k + half], twiddle);
+
+                data[start + k] = even + odd;
+                data[start + k + half] = even - odd;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,230 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "fftconvolver.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    constexpr size_t MaximumFftSize = size_t(1) << 20;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+FftConvolver::FftConvolver(std::span<const double> coeffs, size_t fftSize)
+    : m_filterSize(coeffs.size()),
+      m_fft(fftSize > 0 ? fftSize : optimalFftSize(coeffs.size())),
+      m_spectrum(m_fft.size()),
+      m_block(m_fft.size()),
+      m_history(m_fft.size(), 0.0),
+      m_outputs(m_fft.size() - coeffs.size() + 1, 0.0)
+{
+    assert(!coeffs.empty() && m_fft.size() > coeffs.size());
+
+    // Normalization of the inverse transform is folded into the spectrum
+    const double scale = 1.0 / m_fft.size();
+
+    for (size_t i = 0; i < coeffs.size(); ++i)
+        m_spectrum[i] = scale * coeffs[i];
+
+    m_fft.forward(m_spectrum);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FftConvolver::filterSize() const -> size_t
+{
+    return m_filterSize;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FftConvolver::fftSize() const -> size_t
+{
+    return m_fft.size();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FftConvolver::blockSize() const -> size_t
+{
+    return m_fft.size() - m_filterSize + 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FftConvolver::convolve(std::span<const double> input, std::span<double> output) const
+{
+    const size_t outputSize = input.size() + m_filterSize - 1;
+    assert(output.size() >= outputSize);
+
+    convolve(input, 0, output.first(outputSize));
+    std::fill(output.begin() + outputSize, output.end(), 0.0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FftConvolver::convolve(std::span<const double> input, size_t first,
+                            std::span<double> output, double scale) const
+{
+    std::vector<Fft::Complex> block(m_fft.size());
+    convolve(input, first, output, scale, block);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FftConvolver::convolve(std::span<const double> input, size_t first,
+                            std::span<double> output, double scale,
+                            std::span<Fft::Complex> block) const
+{
+    assert(first + output.size() <= input.size() + m_filterSize - 1);
+    assert(block.size() == m_fft.size());
+
+    const size_t fftSize = m_fft.size();
+    const size_t blockSize = this->blockSize();
+    const size_t history = m_filterSize - 1;
+    const size_t end = first + output.size();
+
+    // Input sample feeding position i of the block producing outputs starting at 'start'
+    auto sample = [&](size_t start, size_t i) -> double {
+        const size_t n = start + i;
+        return (n >= history && n - history < input.size()) ? input[n - history] : 0.0;
+    };
+
+    // Since the filter is real, two blocks can be processed at once by passing one as the real
+    // and the other as the imaginary part of the input
+    for (size_t start = first; start < end; start += 2 * blockSize)
+    {
+        const size_t second = start + blockSize;
+
+        for (size_t i = 0; i < fftSize; ++i)
+            block[i] = { sample(start, i), second < end ? sample(second, i) : 0.0 };
+
+        filterBlock(block);
+
+        for (size_t i = 0; i < blockSize && start + i < end; ++i)
+            output[start - first + i] = scale * block[history + i].real();
+
+        for (size_t i = 0; i < blockSize && second + i < end; ++i)
+            output[second - first + i] = scale * block[history + i].imag();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FftConvolver::process(std::span<const double> input, std::span<double> output)
+{
+    assert(output.size() >= input.size());
+
+    const size_t blockSize = this->blockSize();
+    const size_t history = m_filterSize - 1;
+
+    while (!input.empty())
+    {
+        const size_t count = std::min(input.size(), blockSize - m_position);
+
+        // Input is consumed before writing output, so both may refer to the same buffer
+        std::copy_n(input.begin(), count, m_history.begin() + history + m_position);
+        std::copy_n(m_outputs.begin() + m_position, count, output.begin());
+
+        input = input.subspan(count);
+        output = output.subspan(count);
+        m_position += count;
+
+        if (m_position == blockSize)
+        {
+            std::copy(m_history.begin(), m_history.end(), m_block.begin());
+            filterBlock(m_block);
+
+            for (size_t i = 0; i < blockSize; ++i)
+                m_outputs[i] = m_block[history + i].real();
+
+            std::copy(m_history.end() - history, m_history.end(), m_history.begin());
+            m_position = 0;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FftConvolver::reset()
+{
+    std::fill(m_history.begin(), m_history.end(), 0.0);
+    std::fill(m_outputs.begin(), m_outputs.end(), 0.0);
+    m_position = 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FftConvolver::optimalFftSize(size_t filterSize) -> size_t
+{
+    // Cost per output sample is roughly proportional to N * (log2(N) + 1) / (N - M + 1)
+    size_t bestSize = std::bit_ceil(filterSize + 1);
+    double bestCost = std::numeric_limits<double>::max();
+
+    for (size_t size = bestSize; size <= std::max(MaximumFftSize, bestSize); size *= 2)
+    {
+        const double cost = size * (std::countr_zero(size) + 1.0) / (size - filterSize + 1);
+
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            bestSize = size;
+        }
+    }
+
+    return bestSize;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FftConvolver::filterBlock(std::span<Fft::Complex> block) const
+{
+    m_fft.forward(block);
+
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        const Fft::Complex& a = block[i];
+        const Fft::Complex& b = m_spectrum[i];
+
+        block[i] = { a.real()*b.real() - a.imag()*b.imag(), a.real()*b.imag() + a.imag()*b.real() };
+    }
+
+    m_fft.inverse(block);
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,84 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include "fft.h"
+
+#include <span>
+#include <vector>
+
+// Fast convolution using the overlap-save method. The spectrum of the filter coefficients is
+// computed once on construction. Blocks of blockSize() input samples are filtered with each
+// FFT of size fftSize(), which is chosen to minimize the cost per sample if not given.
+class FftConvolver
+{
+public:
+    FftConvolver(std::span<const double> coeffs, size_t fftSize = 0);
+
+    auto filterSize() const -> size_t;
+    auto fftSize() const -> size_t;
+    auto blockSize() const -> size_t;
+
+    // Full convolution of a complete signal, output must hold input.size() + filterSize() - 1
+    // samples
+    void convolve(std::span<const double> input, std::span<double> output) const;
+
+    // Samples first ... first + output.size() - 1 of the full convolution, multiplied by scale
+    void convolve(std::span<const double> input, size_t first, std::span<double> output,
+                  double scale = 1.0) const;
+
+    // Same without allocating, block must hold fftSize() values
+    void convolve(std::span<const double> input, size_t first, std::span<double> output,
+                  double scale, std::span<Fft::Complex> block) const;
+
+    // Streaming use, produces one output sample per input sample. Output is delayed by
+    // blockSize() samples with respect to convolve(), no memory is allocated.
+    void process(std::span<const double> input, std::span<double> output);
+    void reset();
+
+    static auto optimalFftSize(size_t filterSize) -> size_t;
+
+private:
+    void filterBlock(std::span<Fft::Complex> block) const;
+
+private:
+    size_t m_filterSize;
+    Fft m_fft;
+    std::vector<Fft::Complex> m_spectrum;
+
+    // Streaming state
+    std::vector<Fft::Complex> m_block;
+    std::vector<double> m_history;
+    std::vector<double> m_outputs;
+    size_t m_position = 0;
+};
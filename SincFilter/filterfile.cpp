@@ -0,0 +1,173 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+// Filters a raw sample file with a Kaiser-window design, e.g.
+//
+//   filterfile float recording.raw int16 filtered.raw lowpass 0.1 0.01 90
+//
+// Frequencies are relative to the sample rate. The output has one sample per input sample and
+// is aligned with the input, the filter delay is compensated (SincFilter::Mode::Same).
+
+#include "samplefile.h"
+#include "sincfilter.h"
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    auto parseFormat(std::string_view name) -> std::optional<SampleFile::Format>
+    {
+        if (name == "int16")
+            return SampleFile::Format::Int16;
+
+        if (name == "float")
+            return SampleFile::Format::Float32;
+
+        if (name == "double")
+            return SampleFile::Format::Float64;
+
+        return std::nullopt;
+    }
+
+    auto parseNumber(const char* text) -> std::optional<double>
+    {
+        char* end;
+        const double value = std::strtod(text, &end);
+
+        if (end == text || *end != '\0')
+            return std::nullopt;
+
+        return value;
+    }
+
+    void usage()
+    {
+        std::cerr << "Usage: filterfile INFORMAT INPUT OUTFORMAT OUTPUT TYPE FREQUENCY... "
+                     "TRANSITION ATTENUATION\n"
+                     "Filter a raw sample file into another one.\n"
+                     "\n"
+                     "FORMAT is int16, float or double. TYPE is lowpass or highpass with one\n"
+                     "cutoff frequency, bandpass or stopband with two. Frequencies and the\n"
+                     "transition width are relative to the sample rate, the attenuation is\n"
+                     "given in dB.\n";
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto main(int argc, char* argv[]) -> int
+{
+    if (argc < 9)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string_view type = argv[5];
+    const int frequencies = type == "bandpass" || type == "stopband" ? 2 : 1;
+
+    const auto inputFormat = parseFormat(argv[1]);
+    const auto outputFormat = parseFormat(argv[3]);
+
+    if (!inputFormat || !outputFormat || argc != 8 + frequencies)
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::optional<double> numbers[4];
+
+    for (int i = 0; i < frequencies + 2; ++i)
+    {
+        numbers[i] = parseNumber(argv[6 + i]);
+
+        if (!numbers[i])
+        {
+            std::cerr << "filterfile: invalid number '" << argv[6 + i] << "'\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    const double f1 = *numbers[0];
+    const double f2 = frequencies == 2 ? *numbers[1] : 0.0;
+    const double transition = *numbers[frequencies];
+    const double attenuation = *numbers[frequencies + 1];
+
+    const std::array cutoffs = { f1, f2 };
+
+    if (!SincFilter::validBandEdges(std::span(cutoffs).first(frequencies), transition) ||
+        !(attenuation > 0.0))
+    {
+        std::cerr << "filterfile: band edges (frequency -/+ transition / 2) must lie between 0 "
+                     "and 0.5 without overlapping, the attenuation must be positive\n";
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::optional<SincFilter> filter;
+
+    if (type == "lowpass")
+        filter = SincFilter::lowPass(f1, transition, attenuation);
+    else if (type == "highpass")
+        filter = SincFilter::highPass(f1, transition, attenuation);
+    else if (type == "bandpass")
+        filter = SincFilter::bandPass(f1, f2, transition, attenuation);
+    else if (type == "stopband")
+        filter = SincFilter::stopBand(f1, f2, transition, attenuation);
+    else
+    {
+        std::cerr << "filterfile: unknown filter type '" << type << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!filter)
+    {
+        std::cerr << "filterfile: no filter meets the specification\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!SampleFile::filter(*filter, argv[2], *inputFormat, argv[4], *outputFormat))
+    {
+        std::cerr << "filterfile: cannot filter '" << argv[2] << "' into '" << argv[4] << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#include "filterworkspace.h"
+#include "fftconvolver.h"
+#include "sincfilter.h"
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    template <typename T>
+    auto grow(std::pmr::vector<T>& buffer, size_t size) -> std::span<T>
+    {
+        if (buffer.size() < size)
+            buffer.resize(size);
+
+        return std::span(buffer).first(size);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+FilterWorkspace::FilterWorkspace(std::pmr::memory_resource* resource)
+    : m_coefficients(resource),
+      m_samples(resource),
+      m_spectrum(resource)
+{
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+FilterWorkspace::FilterWorkspace(const SincFilter& filter, std::pmr::memory_resource* resource)
+    : FilterWorkspace(resource)
+{
+    coefficients(filter.size());
+    samples(filter.size() - 1 + SincFilter::ChunkSize);
+    spectrum(filter.fftConvolver().fftSize());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FilterWorkspace::coefficients(size_t size) -> std::span<double>
+{
+    return grow(m_coefficients, size);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FilterWorkspace::samples(size_t size) -> std::span<double>
+{
+    return grow(m_samples, size);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FilterWorkspace::spectrum(size_t size) -> std::span<Fft::Complex>
+{
+    return grow(m_spectrum, size);
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,70 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#pragma once
+
+#include "fft.h"
+
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+class SincFilter;
+
+// Scratch memory for SincFilter and FftConvolver, kept between calls. Filtering in a loop with
+// the same workspace only allocates while the buffers grow to the largest size needed, after
+// that nothing at all. A workspace made for a filter starts out at these sizes, so not even the
+// first call allocates. A workspace must not be used by several threads at once.
+class FilterWorkspace
+{
+public:
+    explicit FilterWorkspace(
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Creates the FFT convolver of the filter and grows all buffers to the sizes its apply
+    // functions need
+    explicit FilterWorkspace(
+        const SincFilter& filter,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // Buffers of the given size, which keep their memory when a smaller size is requested
+    // later. The contents are unspecified.
+    auto coefficients(size_t size) -> std::span<double>;
+    auto samples(size_t size) -> std::span<double>;
+    auto spectrum(size_t size) -> std::span<Fft::Complex>;
+
+private:
+    std::pmr::vector<double> m_coefficients;
+    std::pmr::vector<double> m_samples;
+    std::pmr::vector<Fft::Complex> m_spectrum;
+};
@@ -0,0 +1,76 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Signed fractional fixed-point number in the range [-1, 1) with the given number of fraction
+// bits. Conversions from floating point round to nearest and saturate.
+template <typename T, int FractionBits>
+struct FixedPoint
+{
+    using ValueType = T;
+
+    static constexpr int Bits = FractionBits;
+    static constexpr double Scale = static_cast<double>(int64_t(1) << FractionBits);
+
+    static constexpr T Minimum = std::numeric_limits<T>::min();
+    static constexpr T Maximum = std::numeric_limits<T>::max();
+
+    T value = 0;
+
+    static auto fromDouble(double x) -> FixedPoint
+    {
+        const double scaled = std::clamp(std::round(x * Scale), static_cast<double>(Minimum),
+                                         static_cast<double>(Maximum));
+        return { static_cast<T>(scaled) };
+    }
+
+    static auto saturate(int64_t x) -> FixedPoint
+    {
+        return { static_cast<T>(std::clamp<int64_t>(x, Minimum, Maximum)) };
+    }
+
+    auto toDouble() const -> double
+    {
+        return value / Scale;
+    }
+
+    auto operator==(const FixedPoint&) const -> bool = default;
+};
+
+using Q15 = FixedPoint<int16_t, 15>;
+using Q31 = FixedPoint<int32_t, 31>;
@@ -0,0 +1,200 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "fractionalresampler.h"
+#include "convolutionkernel.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// ---------------------------------------------------------------------------------------------- //
+
+FractionalResampler::FractionalResampler(double ratio, size_t taps, SincFilter::Window window,
+                                         size_t oversampling, double bandwidth)
+    : m_taps(inputTaps(taps, ratio)),
+      m_oversampling(oversampling),
+      m_buffer(m_taps + DefaultChunkSize)
+{
+    assert(taps >= 2 && taps % 2 == 0 && oversampling >= 1);
+    assert(bandwidth > 0.0 && bandwidth <= 1.0);
+
+    setRatio(ratio);
+
+    // The prototype spans m_taps input samples at the oversampled rate. Its cutoff frequency is
+    // relative to the oversampled rate and its gain is normalized at that rate as well, hence
+    // the phases are scaled back up by the oversampling factor.
+    const double cutoff = bandwidth * SincFilter::MaximumFrequency * std::min(ratio, 1.0);
+    const auto prototype = SincFilter::lowPass(m_taps * oversampling + 1, cutoff / oversampling,
+                                               window);
+
+    const auto& coeffs = prototype.coefficients();
+    auto phases = std::make_shared<std::vector<double>>((oversampling + 1) * m_taps);
+
+    const auto gain = static_cast<double>(oversampling);
+
+    for (size_t p = 0; p <= oversampling; ++p)
+    {
+        for (size_t j = 0; j < m_taps; ++j)
+            (*phases)[p * m_taps + j] = gain * coeffs[(m_taps - 1 - j) * oversampling + p];
+    }
+
+    m_phases = std::move(phases);
+
+    reset();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FractionalResampler::ratio() const -> double
+{
+    return m_ratio;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FractionalResampler::taps() const -> size_t
+{
+    return m_taps;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FractionalResampler::setRatio(double ratio)
+{
+    assert(ratio > 0.0);
+
+    const double step = 1.0 / ratio;
+
+    m_ratio = ratio;
+    m_stepIndex = static_cast<size_t>(step);
+    m_stepFraction = step - static_cast<double>(m_stepIndex);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FractionalResampler::maximumOutputSize(size_t inputSize) const -> size_t
+{
+    return static_cast<size_t>(std::ceil(static_cast<double>(inputSize) * m_ratio)) + 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FractionalResampler::process(std::span<const double> input, std::span<double> output)
+    -> size_t
+{
+    const size_t half = m_taps / 2;
+
+    size_t written = 0;
+
+    while (!input.empty())
+    {
+        const size_t count = std::min(input.size(), m_buffer.size() - m_bufferSize);
+
+        std::copy_n(input.begin(), count, m_buffer.begin() + m_bufferSize);
+        m_bufferSize += count;
+
+        input = input.subspan(count);
+
+        // The output at position t depends on input samples floor(t) - half + 1 ... floor(t) + half
+        while (m_index + half < m_bufferSize)
+        {
+            assert(written < output.size());
+            output[written++] = interpolate(&m_buffer[m_index + 1 - half], m_fraction);
+
+            m_index += m_stepIndex;
+            m_fraction += m_stepFraction;
+
+            if (m_fraction >= 1.0)
+            {
+                m_fraction -= 1.0;
+                ++m_index;
+            }
+        }
+
+        // When downsampling, the next output may lie beyond the samples received so far
+        const size_t discarded = std::min(m_index + 1 - half, m_bufferSize);
+
+        std::copy(m_buffer.begin() + discarded, m_buffer.begin() + m_bufferSize, m_buffer.begin());
+
+        m_bufferSize -= discarded;
+        m_index -= discarded;
+    }
+
+    return written;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void FractionalResampler::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0);
+
+    // Input sample 0 is preceded by zeros, so the first output only waits for future samples
+    m_bufferSize = m_taps / 2 - 1;
+    m_index = m_bufferSize;
+    m_fraction = 0.0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FractionalResampler::inputTaps(size_t taps, double ratio) -> size_t
+{
+    assert(ratio > 0.0);
+
+    if (ratio >= 1.0)
+        return taps;
+
+    const auto widened = static_cast<size_t>(std::ceil(static_cast<double>(taps) / ratio));
+    return widened + widened % 2;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto FractionalResampler::interpolate(const double* samples, double fraction) const -> double
+{
+    const double scaled = fraction * static_cast<double>(m_oversampling);
+    const size_t phase = std::min(static_cast<size_t>(scaled), m_oversampling - 1);
+    const double weight = scaled - static_cast<double>(phase);
+
+    const double* coeffs = &(*m_phases)[phase * m_taps];
+
+    double lower = 0.0;
+    double upper = 0.0;
+
+    ConvolutionKernel::correlate(samples, coeffs, m_taps, &lower, 1);
+    ConvolutionKernel::correlate(samples, coeffs + m_taps, m_taps, &upper, 1);
+
+    return lower + weight * (upper - lower);
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,112 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include "sincfilter.h"
+
+#include <memory>
+#include <span>
+#include <vector>
+
+// Converts between arbitrary sample rates. A windowed-sinc low-pass filter is designed once at
+// a high oversampling factor and stored as a table of polyphase components. For each output
+// sample, the two phases next to its fractional input position are applied and the results
+// interpolated linearly. The table is immutable and shared between copies, so a resampler set
+// up once can be copied for each channel of a multichannel stream.
+class FractionalResampler
+{
+public:
+    static constexpr size_t DefaultTaps = 32;
+    static constexpr size_t DefaultOversampling = 512;
+    static constexpr double DefaultBandwidth = 0.9;
+
+    static constexpr auto DefaultWindowType = SincFilter::WindowType::Blackman;
+
+    static constexpr size_t DefaultChunkSize = 256;
+
+public:
+    // Ratio is the output rate divided by the input rate. The cutoff frequency is set to
+    // bandwidth times the lower of both Nyquist frequencies. Taps is the even length of the
+    // kernel in samples of the lower rate: When downsampling, the kernel is widened to taps /
+    // ratio input samples, rounded up to an even number, so that the transition band narrows
+    // along with the cutoff frequency. Memory and time per output sample grow accordingly.
+    FractionalResampler(double ratio, size_t taps = DefaultTaps,
+                        SincFilter::Window window = DefaultWindowType,
+                        size_t oversampling = DefaultOversampling,
+                        double bandwidth = DefaultBandwidth);
+
+    auto ratio() const -> double;
+
+    // Number of input samples each output sample depends on
+    auto taps() const -> size_t;
+
+    // Changes the conversion ratio without redesigning or widening the filter, e.g. to follow
+    // clock drift. The new ratio takes effect with the next output sample.
+    void setRatio(double ratio);
+
+    // Maximum number of output samples process() produces for the given number of input samples
+    auto maximumOutputSize(size_t inputSize) const -> size_t;
+
+    // Output sample k corresponds to input position k / ratio(), with input sample 0 at
+    // position 0. Outputs are produced as soon as taps() / 2 input samples beyond their position
+    // are available. Returns the number of output samples written.
+    auto process(std::span<const double> input, std::span<double> output) -> size_t;
+    void reset();
+
+private:
+    static auto inputTaps(size_t taps, double ratio) -> size_t;
+
+    auto interpolate(const double* samples, double fraction) const -> double;
+
+private:
+    double m_ratio;
+
+    // Distance between output samples split into whole input samples and a fraction
+    size_t m_stepIndex = 0;
+    double m_stepFraction = 0.0;
+
+    size_t m_taps;
+    size_t m_oversampling;
+
+    // Phase p holds the reversed coefficients for fractional positions p / oversampling, one
+    // more phase than the oversampling factor is stored to interpolate up to the next sample
+    std::shared_ptr<const std::vector<double>> m_phases;
+
+    // Input samples followed by space for the current chunk, and the position of the next
+    // output sample relative to the start of the buffer. The fraction is kept separately, so it
+    // does not depend on how the input is split into blocks.
+    std::vector<double> m_buffer;
+    size_t m_bufferSize = 0;
+    size_t m_index = 0;
+    double m_fraction = 0.0;
+};
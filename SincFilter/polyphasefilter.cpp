@@ -0,0 +1,453 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "polyphasefilter.h"
+#include "convolutionkernel.h"
+#include "sincfilter.h"
+
+#include <algorithm>
+#include <cassert>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    // Splits coeffs into phases p = 0 ... factor - 1 holding coeffs[j * factor + p]. Each phase
+    // is zero-padded to the same size and stored in reverse order for the convolution kernel.
+    auto splitPhases(std::span<const double> coeffs, size_t factor, double gain)
+        -> std::vector<double>
+    {
+        const size_t phaseSize = (coeffs.size() + factor - 1) / factor;
+        std::vector<double> phases(factor * phaseSize, 0.0);
+
+        for (size_t p = 0; p < factor; ++p)
+        {
+            for (size_t j = 0; j * factor + p < coeffs.size(); ++j)
+                phases[p * phaseSize + phaseSize - 1 - j] = gain * coeffs[j * factor + p];
+        }
+
+        return phases;
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PolyphaseDecimator::PolyphaseDecimator(const SincFilter& filter, size_t factor)
+    : PolyphaseDecimator(filter.coefficients(), factor)
+{
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PolyphaseDecimator::PolyphaseDecimator(std::span<const double> coeffs, size_t factor)
+    : m_factor(factor),
+      m_filterSize(coeffs.size()),
+      m_phaseSize((coeffs.size() + factor - 1) / factor),
+      m_phases(splitPhases(coeffs, factor, 1.0)),
+      m_buffers(factor * (m_phaseSize + DefaultChunkSize), 0.0),
+      m_scratch(DefaultChunkSize)
+{
+    assert(factor >= 1 && !coeffs.empty());
+    reset();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseDecimator::factor() const -> size_t
+{
+    return m_factor;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseDecimator::outputSize(size_t inputSize) const -> size_t
+{
+    return (inputSize + m_filterSize - 1 + m_factor - 1) / m_factor;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseDecimator::apply(std::span<const double> input, std::span<double> output) const
+{
+    const size_t outputSize = this->outputSize(input.size());
+    assert(output.size() >= outputSize);
+
+    // Phase p is the input sequence x[i * factor - p], preceded by the history of zeros
+    const size_t history = m_phaseSize - 1;
+
+    std::vector<double> phase(history + outputSize);
+    std::vector<double> scratch(outputSize);
+
+    for (size_t p = 0; p < m_factor; ++p)
+    {
+        for (size_t i = 0; i < outputSize; ++i)
+        {
+            const size_t n = i * m_factor - p;
+            phase[history + i] = (i * m_factor >= p && n < input.size()) ? input[n] : 0.0;
+        }
+
+        ConvolutionKernel::correlate(phase.data(), &m_phases[p * m_phaseSize], m_phaseSize,
+                                     p == 0 ? output.data() : scratch.data(), outputSize);
+
+        if (p > 0)
+        {
+            for (size_t i = 0; i < outputSize; ++i)
+                output[i] += scratch[i];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseDecimator::process(std::span<const double> input, std::span<double> output) -> size_t
+{
+    const size_t bufferSize = m_phaseSize + DefaultChunkSize;
+    const size_t history = m_phaseSize - 1;
+
+    size_t written = 0;
+
+    // Output m needs the samples x[(m - 1) * factor + 1] ... x[m * factor], called a frame
+    // here. Sample x[m * factor - p] belongs to phase p.
+    for (double sample : input)
+    {
+        const size_t p = m_factor - 1 - m_framePosition;
+        m_buffers[p * bufferSize + history + m_frames] = sample;
+
+        if (++m_framePosition == m_factor)
+        {
+            m_framePosition = 0;
+
+            if (++m_frames == DefaultChunkSize)
+            {
+                assert(output.size() >= written + m_frames);
+                written += m_frames;
+                flush(&output[written - m_frames]);
+            }
+        }
+    }
+
+    if (m_frames > 0)
+    {
+        assert(output.size() >= written + m_frames);
+        written += m_frames;
+        flush(&output[written - m_frames]);
+    }
+
+    return written;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseDecimator::reset()
+{
+    std::fill(m_buffers.begin(), m_buffers.end(), 0.0);
+
+    // The first frame only consists of x[0], earlier samples are zero
+    m_frames = 0;
+    m_framePosition = m_factor - 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseDecimator::flush(double* output)
+{
+    const size_t bufferSize = m_phaseSize + DefaultChunkSize;
+    const size_t count = m_frames;
+
+    for (size_t p = 0; p < m_factor; ++p)
+    {
+        double* buffer = &m_buffers[p * bufferSize];
+
+        ConvolutionKernel::correlate(buffer, &m_phases[p * m_phaseSize], m_phaseSize,
+                                     p == 0 ? output : m_scratch.data(), count);
+
+        if (p > 0)
+        {
+            for (size_t i = 0; i < count; ++i)
+                output[i] += m_scratch[i];
+        }
+
+        // Keep history and the slot of the current partial frame
+        std::copy_n(buffer + count, m_phaseSize, buffer);
+    }
+
+    m_frames = 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PolyphaseInterpolator::PolyphaseInterpolator(const SincFilter& filter, size_t factor)
+    : PolyphaseInterpolator(filter.coefficients(), factor)
+{
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PolyphaseInterpolator::PolyphaseInterpolator(std::span<const double> coeffs, size_t factor)
+    : m_factor(factor),
+      m_filterSize(coeffs.size()),
+      m_phaseSize((coeffs.size() + factor - 1) / factor),
+      m_phases(splitPhases(coeffs, factor, static_cast<double>(factor))),
+      m_buffer(m_phaseSize - 1 + DefaultChunkSize, 0.0),
+      m_scratch(DefaultChunkSize)
+{
+    assert(factor >= 1 && !coeffs.empty());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseInterpolator::factor() const -> size_t
+{
+    return m_factor;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseInterpolator::outputSize(size_t inputSize) const -> size_t
+{
+    return inputSize * m_factor + m_filterSize - 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseInterpolator::apply(std::span<const double> input, std::span<double> output) const
+{
+    const size_t outputSize = this->outputSize(input.size());
+    assert(output.size() >= outputSize);
+
+    // Output sample m * factor + q is computed by phase q from input samples up to x[m]
+    const size_t history = m_phaseSize - 1;
+    const size_t frames = (outputSize + m_factor - 1) / m_factor;
+
+    std::vector<double> padded(history + frames, 0.0);
+    std::copy(input.begin(), input.end(), padded.begin() + history);
+
+    std::vector<double> scratch(frames);
+
+    for (size_t q = 0; q < m_factor; ++q)
+    {
+        ConvolutionKernel::correlate(padded.data(), &m_phases[q * m_phaseSize], m_phaseSize,
+                                     scratch.data(), frames);
+
+        for (size_t m = 0; m < frames && m * m_factor + q < outputSize; ++m)
+            output[m * m_factor + q] = scratch[m];
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseInterpolator::process(std::span<const double> input, std::span<double> output)
+{
+    assert(output.size() >= input.size() * m_factor);
+
+    const size_t history = m_phaseSize - 1;
+
+    while (!input.empty())
+    {
+        const size_t count = std::min(input.size(), DefaultChunkSize);
+
+        std::copy_n(input.begin(), count, m_buffer.begin() + history);
+
+        for (size_t q = 0; q < m_factor; ++q)
+        {
+            ConvolutionKernel::correlate(m_buffer.data(), &m_phases[q * m_phaseSize],
+                                         m_phaseSize, m_scratch.data(), count);
+
+            for (size_t m = 0; m < count; ++m)
+                output[m * m_factor + q] = m_scratch[m];
+        }
+
+        std::copy_n(m_buffer.begin() + count, history, m_buffer.begin());
+
+        input = input.subspan(count);
+        output = output.subspan(count * m_factor);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseInterpolator::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PolyphaseChannelizer::PolyphaseChannelizer(const SincFilter& prototype, size_t channels)
+    : PolyphaseChannelizer(prototype.coefficients(), channels)
+{
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+PolyphaseChannelizer::PolyphaseChannelizer(std::span<const double> coeffs, size_t channels)
+    : m_channels(channels),
+      m_filterSize(coeffs.size()),
+      m_phaseSize((coeffs.size() + channels - 1) / channels),
+      m_phases(splitPhases(coeffs, channels, 1.0)),
+      m_fft(channels),
+      m_buffers(channels * (m_phaseSize + DefaultChunkSize), 0.0),
+      m_phaseOutputs(channels * DefaultChunkSize)
+{
+    assert(channels >= 2 && (channels & (channels - 1)) == 0 && !coeffs.empty());
+    reset();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseChannelizer::channels() const -> size_t
+{
+    return m_channels;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseChannelizer::outputSize(size_t inputSize) const -> size_t
+{
+    return (inputSize + m_filterSize - 1 + m_channels - 1) / m_channels;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseChannelizer::apply(std::span<const double> input, std::span<Complex> output) const
+{
+    const size_t frames = outputSize(input.size());
+    assert(output.size() >= frames * m_channels);
+
+    // Phase p is the input sequence x[i * channels - p], preceded by the history of zeros
+    const size_t history = m_phaseSize - 1;
+
+    std::vector<double> phase(history + frames);
+    std::vector<double> phaseOutputs(m_channels * frames);
+
+    for (size_t p = 0; p < m_channels; ++p)
+    {
+        for (size_t i = 0; i < frames; ++i)
+        {
+            const size_t n = i * m_channels - p;
+            phase[history + i] = (i * m_channels >= p && n < input.size()) ? input[n] : 0.0;
+        }
+
+        ConvolutionKernel::correlate(phase.data(), &m_phases[p * m_phaseSize], m_phaseSize,
+                                     &phaseOutputs[p * frames], frames);
+    }
+
+    combine(phaseOutputs.data(), frames, frames, output.data());
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto PolyphaseChannelizer::process(std::span<const double> input, std::span<Complex> output)
+    -> size_t
+{
+    const size_t bufferSize = m_phaseSize + DefaultChunkSize;
+    const size_t history = m_phaseSize - 1;
+
+    size_t written = 0;
+
+    for (double sample : input)
+    {
+        const size_t p = m_channels - 1 - m_framePosition;
+        m_buffers[p * bufferSize + history + m_frames] = sample;
+
+        if (++m_framePosition == m_channels)
+        {
+            m_framePosition = 0;
+
+            if (++m_frames == DefaultChunkSize)
+            {
+                assert(output.size() >= (written + m_frames) * m_channels);
+                written += m_frames;
+                flush(&output[(written - m_frames) * m_channels]);
+            }
+        }
+    }
+
+    if (m_frames > 0)
+    {
+        assert(output.size() >= (written + m_frames) * m_channels);
+        written += m_frames;
+        flush(&output[(written - m_frames) * m_channels]);
+    }
+
+    return written;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseChannelizer::reset()
+{
+    std::fill(m_buffers.begin(), m_buffers.end(), 0.0);
+
+    m_frames = 0;
+    m_framePosition = m_channels - 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseChannelizer::combine(const double* phaseOutputs, size_t stride, size_t count,
+                                   Complex* output) const
+{
+    // Channel k is the sum of phase p rotated by exp(2 pi j k p / channels), which is the
+    // unnormalized inverse transform across the phases
+    for (size_t i = 0; i < count; ++i)
+    {
+        const std::span<Complex> frame(output + i * m_channels, m_channels);
+
+        for (size_t p = 0; p < m_channels; ++p)
+            frame[p] = phaseOutputs[p * stride + i];
+
+        m_fft.inverse(frame);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void PolyphaseChannelizer::flush(Complex* output)
+{
+    const size_t bufferSize = m_phaseSize + DefaultChunkSize;
+    const size_t count = m_frames;
+
+    for (size_t p = 0; p < m_channels; ++p)
+    {
+        double* buffer = &m_buffers[p * bufferSize];
+
+        ConvolutionKernel::correlate(buffer, &m_phases[p * m_phaseSize], m_phaseSize,
+                                     &m_phaseOutputs[p * DefaultChunkSize], count);
+
+        std::copy_n(buffer + count, m_phaseSize, buffer);
+    }
+
+    combine(m_phaseOutputs.data(), DefaultChunkSize, count, output);
+    m_frames = 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
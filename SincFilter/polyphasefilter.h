@@ -0,0 +1,168 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include "fft.h"
+
+#include <span>
+#include <vector>
+
+class SincFilter;
+
+// Sample-rate conversion by integer factors using the polyphase decomposition of a filter. The
+// decimator only computes the output samples that are kept, the interpolator skips all
+// multiplications with the zeros inserted between input samples. Both produce the same output
+// as zero-stuffing or downsampling around SincFilter::apply() at a fraction of the cost.
+
+class PolyphaseDecimator
+{
+public:
+    static constexpr size_t DefaultChunkSize = 256;
+
+public:
+    PolyphaseDecimator(const SincFilter& filter, size_t factor);
+    PolyphaseDecimator(std::span<const double> coeffs, size_t factor);
+
+    auto factor() const -> size_t;
+
+    // Block form, output sample m equals sample m * factor() of the full convolution
+    auto outputSize(size_t inputSize) const -> size_t;
+    void apply(std::span<const double> input, std::span<double> output) const;
+
+    // Streaming form, returns the number of output samples written, which is at most
+    // input.size() / factor() + 1
+    auto process(std::span<const double> input, std::span<double> output) -> size_t;
+    void reset();
+
+private:
+    void flush(double* output);
+
+private:
+    size_t m_factor;
+    size_t m_filterSize;
+    size_t m_phaseSize;
+    std::vector<double> m_phases; // reversed and zero-padded coefficients of each phase
+
+    // Streaming state, one buffer per phase holding history, chunk and a partial frame
+    std::vector<double> m_buffers;
+    std::vector<double> m_scratch;
+    size_t m_frames = 0;
+    size_t m_framePosition = 0;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+class PolyphaseInterpolator
+{
+public:
+    static constexpr size_t DefaultChunkSize = 256;
+
+public:
+    // The gain compensates for the energy lost by zero-stuffing
+    PolyphaseInterpolator(const SincFilter& filter, size_t factor);
+    PolyphaseInterpolator(std::span<const double> coeffs, size_t factor);
+
+    auto factor() const -> size_t;
+
+    // Block form, output equals the full convolution of the zero-stuffed input
+    auto outputSize(size_t inputSize) const -> size_t;
+    void apply(std::span<const double> input, std::span<double> output) const;
+
+    // Streaming form, writes exactly input.size() * factor() output samples
+    void process(std::span<const double> input, std::span<double> output);
+    void reset();
+
+private:
+    size_t m_factor;
+    size_t m_filterSize;
+    size_t m_phaseSize;
+    std::vector<double> m_phases;
+
+    std::vector<double> m_buffer;
+    std::vector<double> m_scratch;
+};
+
+// ---------------------------------------------------------------------------------------------- //
+
+// Uniform DFT filter bank splitting a real signal into channels() complex sub-bands centered on
+// the frequencies k / channels(), each decimated by channels(). All channels share the phases of
+// one prototype low-pass with a cutoff of about 0.5 / channels(), which are combined by an
+// inverse FFT per output frame. Per input sample this costs about the prototype size divided by
+// channels() plus log2(channels()) operations, where separate band-pass filters cost the
+// prototype size for each channel. Since the input is real, channel channels() - k is the
+// complex conjugate of channel k.
+class PolyphaseChannelizer
+{
+public:
+    using Complex = Fft::Complex;
+
+    static constexpr size_t DefaultChunkSize = 256;
+
+public:
+    // The number of channels must be a power of two
+    PolyphaseChannelizer(const SincFilter& prototype, size_t channels);
+    PolyphaseChannelizer(std::span<const double> coeffs, size_t channels);
+
+    auto channels() const -> size_t;
+
+    // Block form, returns the number of frames of channels() samples. Channel k of frame m is
+    // stored at output[m * channels() + k] and equals sample m * channels() of the full
+    // convolution of the input with prototype[i] * exp(2 pi j k i / channels()).
+    auto outputSize(size_t inputSize) const -> size_t;
+    void apply(std::span<const double> input, std::span<Complex> output) const;
+
+    // Streaming form, returns the number of frames written, which is at most
+    // input.size() / channels() + 1
+    auto process(std::span<const double> input, std::span<Complex> output) -> size_t;
+    void reset();
+
+private:
+    // Combines the phase outputs of count frames, stored phase by phase with the given stride,
+    // into the channels of each frame
+    void combine(const double* phaseOutputs, size_t stride, size_t count, Complex* output) const;
+
+    void flush(Complex* output);
+
+private:
+    size_t m_channels;
+    size_t m_filterSize;
+    size_t m_phaseSize;
+    std::vector<double> m_phases;
+    Fft m_fft;
+
+    // Streaming state, one buffer per phase as in PolyphaseDecimator
+    std::vector<double> m_buffers;
+    std::vector<double> m_phaseOutputs;
+    size_t m_frames = 0;
+    size_t m_framePosition = 0;
+};
@@ -0,0 +1,394 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#include "samplefile.h"
+#include "fftconvolver.h"
+#include "fixedpoint.h"
+#include "sincfilterstream.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <semaphore>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    // Read-only mapping of a complete file. Empty files are not mapped.
+    class InputFile
+    {
+    public:
+        explicit InputFile(const std::string& path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+
+            if (fd < 0)
+                return;
+
+            struct stat status;
+
+            if (::fstat(fd, &status) == 0)
+            {
+                m_size = static_cast<size_t>(status.st_size);
+
+                if (m_size == 0)
+                    m_open = true;
+                else
+                {
+                    void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                    if (data != MAP_FAILED)
+                    {
+                        m_data = static_cast<const std::byte*>(data);
+                        m_open = true;
+
+                        ::madvise(data, m_size, MADV_SEQUENTIAL);
+                    }
+                }
+            }
+
+            // The mapping keeps the file referenced
+            ::close(fd);
+        }
+
+        ~InputFile()
+        {
+            if (m_data)
+                ::munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+
+        InputFile(const InputFile&) = delete;
+        auto operator=(const InputFile&) -> InputFile& = delete;
+
+        auto isOpen() const -> bool
+        {
+            return m_open;
+        }
+
+        auto bytes() const -> std::span<const std::byte>
+        {
+            return { m_data, m_data ? m_size : 0 };
+        }
+
+        // Starts reading the given range in the background
+        void prefetch(size_t offset, size_t size) const
+        {
+            advise(offset, size, MADV_WILLNEED);
+        }
+
+        // Drops the given range from the address space once decoded, so the resident memory
+        // stays constant. The pages remain in the page cache.
+        void release(size_t offset, size_t size) const
+        {
+            advise(offset, size, MADV_DONTNEED);
+        }
+
+    private:
+        void advise(size_t offset, size_t size, int advice) const
+        {
+            if (!m_data || offset >= m_size)
+                return;
+
+            // madvise() needs a page-aligned address, the range is widened to whole pages
+            static const size_t PageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+            const size_t first = offset / PageSize * PageSize;
+            const size_t last = std::min(offset + size, m_size);
+
+            ::madvise(const_cast<std::byte*>(m_data) + first, last - first, advice);
+        }
+
+    private:
+        const std::byte* m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+    };
+
+    class OutputFile
+    {
+    public:
+        explicit OutputFile(const std::string& path)
+            : m_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644))
+        {
+        }
+
+        ~OutputFile()
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        OutputFile(const OutputFile&) = delete;
+        auto operator=(const OutputFile&) -> OutputFile& = delete;
+
+        auto isOpen() const -> bool
+        {
+            return m_fd >= 0;
+        }
+
+        auto write(std::span<const std::byte> bytes) -> bool
+        {
+            while (!bytes.empty())
+            {
+                const ssize_t written = ::write(m_fd, bytes.data(), bytes.size());
+
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    return false;
+                }
+
+                bytes = bytes.subspan(static_cast<size_t>(written));
+            }
+
+            return true;
+        }
+
+        // Reports write errors that are only detected when the file is closed
+        auto close() -> bool
+        {
+            const int fd = m_fd;
+            m_fd = -1;
+
+            return ::close(fd) == 0;
+        }
+
+    private:
+        int m_fd;
+    };
+
+    // Samples are copied byte by byte, the file contents need not be aligned
+    template <typename T>
+    void decode(const std::byte* bytes, std::span<double> samples)
+    {
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            T value;
+            std::memcpy(&value, bytes + i*sizeof(T), sizeof(T));
+
+            if constexpr (std::is_same_v<T, int16_t>)
+                samples[i] = Q15{ value }.toDouble();
+            else
+                samples[i] = static_cast<double>(value);
+        }
+    }
+
+    template <typename T>
+    void encode(std::span<const double> samples, std::byte* bytes)
+    {
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            T value;
+
+            if constexpr (std::is_same_v<T, int16_t>)
+                value = Q15::fromDouble(samples[i]).value;
+            else
+                value = static_cast<T>(samples[i]);
+
+            std::memcpy(bytes + i*sizeof(T), &value, sizeof(T));
+        }
+    }
+
+    void decode(SampleFile::Format format, const std::byte* bytes, std::span<double> samples)
+    {
+        switch (format)
+        {
+            case SampleFile::Format::Int16:   decode<int16_t>(bytes, samples); break;
+            case SampleFile::Format::Float32: decode<float>(bytes, samples);   break;
+            case SampleFile::Format::Float64: decode<double>(bytes, samples);  break;
+        }
+    }
+
+    void encode(SampleFile::Format format, std::span<const double> samples, std::byte* bytes)
+    {
+        switch (format)
+        {
+            case SampleFile::Format::Int16:   encode<int16_t>(samples, bytes); break;
+            case SampleFile::Format::Float32: encode<float>(samples, bytes);   break;
+            case SampleFile::Format::Float64: encode<double>(samples, bytes);  break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto SampleFile::sampleSize(Format format) -> size_t
+{
+    switch (format)
+    {
+        case Format::Int16:   return sizeof(int16_t);
+        case Format::Float32: return sizeof(float);
+        case Format::Float64: return sizeof(double);
+    }
+
+    return 0;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto SampleFile::filter(const SincFilter& filter, const std::string& inputPath,
+                        Format inputFormat, const std::string& outputPath, Format outputFormat,
+                        SincFilter::Mode mode, double scale, SincFilter::Method method) -> bool
+{
+    const InputFile input(inputPath);
+
+    if (!input.isOpen())
+        return false;
+
+    const size_t inputWidth = sampleSize(inputFormat);
+    const size_t outputWidth = sampleSize(outputFormat);
+
+    if (input.bytes().size() % inputWidth != 0)
+        return false;
+
+    OutputFile output(outputPath);
+
+    if (!output.isOpen())
+        return false;
+
+    const size_t inputCount = input.bytes().size() / inputWidth;
+
+    if (method == SincFilter::Method::Automatic)
+        method = filter.useFft(inputCount) ? SincFilter::Method::Fft : SincFilter::Method::Direct;
+
+    // Only one of them is used. The FFT convolver gets its own streaming state and is scaled
+    // after each block, its output is delayed by one FFT block.
+    std::optional<SincFilterStream> stream;
+    std::optional<FftConvolver> convolver;
+
+    if (method == SincFilter::Method::Fft)
+        convolver.emplace(filter.coefficients());
+    else
+        stream.emplace(filter, scale);
+
+    const size_t delay = convolver ? convolver->blockSize() : 0;
+
+    // The engines produce the full convolution from the start, so the input is followed by
+    // zeros until the last requested sample and the samples before the first one are dropped
+    const size_t first = filter.firstOutput(mode) + delay;
+    const size_t outputCount = filter.outputSize(inputCount, mode);
+    const size_t total = outputCount > 0 ? first + outputCount : 0;
+    const size_t blockCount = (total + BlockSize - 1) / BlockSize;
+
+    std::array<std::vector<double>, 2> blocks = { std::vector<double>(BlockSize),
+                                                  std::vector<double>(BlockSize) };
+    std::vector<std::byte> encoded(BlockSize * outputWidth);
+
+    std::counting_semaphore<2> empty(2);
+    std::counting_semaphore<2> filled(0);
+    std::atomic<bool> failed = false;
+
+    std::thread reader([&] {
+        for (size_t b = 0; b < blockCount; ++b)
+        {
+            empty.acquire();
+
+            const size_t begin = b * BlockSize;
+            const size_t count = std::min(BlockSize, total - begin);
+            const size_t available = begin < inputCount ? std::min(count, inputCount - begin) : 0;
+
+            if (!failed)
+            {
+                const std::span block = std::span(blocks[b % 2]).first(count);
+
+                input.prefetch((begin + BlockSize) * inputWidth, BlockSize * inputWidth);
+
+                decode(inputFormat, input.bytes().data() + begin*inputWidth,
+                       block.first(available));
+                std::fill(block.begin() + available, block.end(), 0.0);
+
+                input.release(begin * inputWidth, available * inputWidth);
+            }
+
+            filled.release();
+        }
+    });
+
+    for (size_t b = 0; b < blockCount; ++b)
+    {
+        filled.acquire();
+
+        const size_t begin = b * BlockSize;
+        const size_t count = std::min(BlockSize, total - begin);
+
+        // After a failed write the remaining blocks are only passed back to the reader
+        if (!failed)
+        {
+            const std::span block = std::span(blocks[b % 2]).first(count);
+
+            if (convolver)
+            {
+                convolver->process(block, block);
+
+                if (scale != 1.0)
+                {
+                    for (auto& y : block)
+                        y *= scale;
+                }
+            }
+            else
+                stream->process(block, block);
+
+            const size_t skipped = begin < first ? std::min(count, first - begin) : 0;
+            const size_t written = count - skipped;
+
+            encode(outputFormat, block.subspan(skipped), encoded.data());
+
+            if (!output.write(std::span(encoded).first(written * outputWidth)))
+                failed = true;
+        }
+
+        empty.release();
+    }
+
+    reader.join();
+
+    return output.close() && !failed;
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,69 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#pragma once
+
+#include "sincfilter.h"
+
+#include <cstddef>
+#include <string>
+
+// Filters raw binary sample files that are too large for memory. The input is memory-mapped and
+// decoded in blocks of BlockSize samples by a reader thread, which prefetches the following
+// block while the current one is filtered and written, so at most two blocks are held at any
+// time. Blocks are filtered by SincFilterStream or, for long filters, by the streaming
+// FftConvolver. Samples are stored in native byte order, 16-bit integers as Q15.
+class SampleFile
+{
+public:
+    enum class Format
+    {
+        Int16,
+        Float32,
+        Float64
+    };
+
+    // Small enough for the decoded block to stay in the L2 cache while it is filtered
+    static constexpr size_t BlockSize = size_t(1) << 15;
+
+    static auto sampleSize(Format format) -> size_t;
+
+    // Writes the given part of the convolution of the input file with the filter to the output
+    // file, which is created or truncated. The automatic method chooses like SincFilter::apply()
+    // for the whole file. Returns false if a file cannot be opened, mapped or written, or if the
+    // input size is not a multiple of the sample size.
+    static auto filter(const SincFilter& filter, const std::string& inputPath,
+                       Format inputFormat, const std::string& outputPath, Format outputFormat,
+                       SincFilter::Mode mode = SincFilter::Mode::Same, double scale = 1.0,
+                       SincFilter::Method method = SincFilter::Method::Automatic) -> bool;
+};
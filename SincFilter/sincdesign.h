@@ -0,0 +1,215 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#pragma once
+
+#include "sincfilter.h"
+
+#include <array>
+#include <cstddef>
+
+// Compile-time form of the SincFilter factory functions for filters of a fixed size, e.g.
+//
+//     constexpr auto coeffs = SincDesign<121>::lowPass(0.4, SincFilter::WindowType::Blackman);
+//
+// The coefficients are returned in a std::array and can be passed as std::span to
+// SincFilter::applyCoefficients(), which filters with them in place without allocating. The
+// filter classes, SincFilter, SincFilterStream, TypedFilter and the polyphase classes, accept
+// them as well, but copy them into their own heap memory. Sines and cosines are evaluated with
+// Taylor series after range reduction, so designs agree with SincFilter to about 1e-15.
+template <size_t Size>
+class SincDesign
+{
+    static_assert(Size >= SincFilter::MinimumSize && Size % 2 == 1);
+
+public:
+    using Coefficients = std::array<double, Size>;
+    using Window = SincFilter::Window;
+
+public:
+    static constexpr auto lowPass(double fc, Window window = SincFilter::DefaultWindowType)
+        -> Coefficients
+    {
+        Coefficients coeffs = {};
+
+        // The first half including the center is computed, the rest is mirrored
+        for (size_t i = 0; i <= Size / 2; ++i)
+        {
+            const double offset = static_cast<double>(i) - Center;
+            const double sinc = offset == 0.0 ? TwoPi * fc : sin(TwoPi * fc * offset) / offset;
+
+            coeffs[i] = sinc * windowValue(window, i);
+            coeffs[Size - 1 - i] = coeffs[i];
+        }
+
+        double sum = 0.0;
+
+        for (double c : coeffs)
+            sum += c;
+
+        for (auto& c : coeffs)
+            c /= sum;
+
+        return coeffs;
+    }
+
+    static constexpr auto highPass(double fc, Window window = SincFilter::DefaultWindowType)
+        -> Coefficients
+    {
+        return invert(lowPass(fc, window));
+    }
+
+    static constexpr auto stopBand(double fl, double fh,
+                                   Window window = SincFilter::DefaultWindowType) -> Coefficients
+    {
+        const auto low = lowPass(fl, window);
+        auto coeffs = highPass(fh, window);
+
+        for (size_t i = 0; i < Size; ++i)
+            coeffs[i] += low[i];
+
+        return coeffs;
+    }
+
+    static constexpr auto bandPass(double fl, double fh,
+                                   Window window = SincFilter::DefaultWindowType) -> Coefficients
+    {
+        return invert(stopBand(fl, fh, window));
+    }
+
+private:
+    static constexpr double Pi = 3.14159265358979323846;
+    static constexpr double TwoPi = 2.0 * Pi;
+    static constexpr double HalfPi = Pi / 2.0;
+
+    static constexpr double Center = static_cast<double>((Size - 1) / 2);
+
+    static constexpr auto invert(Coefficients coeffs) -> Coefficients
+    {
+        for (auto& c : coeffs)
+            c = -c;
+
+        coeffs[(Size - 1) / 2] += 1.0;
+        return coeffs;
+    }
+
+    static constexpr auto windowValue(Window window, size_t i) -> double
+    {
+        const double x = TwoPi * static_cast<double>(i) / static_cast<double>(Size - 1);
+
+        switch (window.type)
+        {
+        case SincFilter::WindowType::None:
+            return 1.0;
+
+        case SincFilter::WindowType::Blackman:
+            return 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+
+        case SincFilter::WindowType::Hamming:
+            return 0.54 - 0.46 * cos(x);
+
+        case SincFilter::WindowType::Kaiser:
+        {
+            const double r = (static_cast<double>(i) - Center) / Center;
+            return SincFilter::besselI0(window.beta * sqrt(1.0 - r*r)) /
+                   SincFilter::besselI0(window.beta);
+        }
+        }
+
+        return 1.0;
+    }
+
+    // Sine and cosine reduced to [-pi/4, pi/4], where the series converge to full precision
+    // within a few terms
+    static constexpr auto sin(double x) -> double
+    {
+        const double turns = x / HalfPi;
+        const auto quadrant = static_cast<long long>(turns < 0.0 ? turns - 0.5 : turns + 0.5);
+        const double r = x - static_cast<double>(quadrant) * HalfPi;
+
+        switch (((quadrant % 4) + 4) % 4)
+        {
+        case 0: return sinSeries(r);
+        case 1: return cosSeries(r);
+        case 2: return -sinSeries(r);
+        default: return -cosSeries(r);
+        }
+    }
+
+    static constexpr auto cos(double x) -> double
+    {
+        return sin(x + HalfPi);
+    }
+
+    static constexpr auto sinSeries(double x) -> double
+    {
+        double term = x;
+        double sum = x;
+
+        for (int k = 1; k < 12; ++k)
+        {
+            term *= -x*x / ((2*k) * (2*k + 1));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static constexpr auto cosSeries(double x) -> double
+    {
+        double term = 1.0;
+        double sum = 1.0;
+
+        for (int k = 1; k < 12; ++k)
+        {
+            term *= -x*x / ((2*k - 1) * (2*k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Newton's method starting above the root, so the iteration decreases monotonically
+    static constexpr auto sqrt(double x) -> double
+    {
+        if (x <= 0.0)
+            return 0.0;
+
+        double y = x > 1.0 ? x : 1.0;
+
+        for (double next = 0.5 * (y + x / y); next < y; next = 0.5 * (y + x / y))
+            y = next;
+
+        return y;
+    }
+};
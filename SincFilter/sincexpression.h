@@ -0,0 +1,266 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include "sincfilter.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+// Lazy form of the SincFilter algebra. Sums, differences and inversions of windowed-sinc
+// low-pass filters of equal size and window are recorded as weighted low-pass terms plus a unit
+// impulse at the center, with the number of terms fixed at compile time. Evaluation computes the
+// window and the sinc values of each term once, for half of the symmetric coefficients only.
+// The windowed values of each term are kept until its gain is known and are then normalized and
+// summed. The first two terms are kept in the two halves of the output, only expressions with
+// more terms need scratch memory.
+//
+// Products of filters are convolutions of the coefficients and remain with SincFilter.
+template <size_t Terms>
+class SincExpression
+{
+public:
+    using Window = SincFilter::Window;
+
+    struct Term
+    {
+        double fc;
+        double weight;
+    };
+
+public:
+    SincExpression(size_t size, Window window, const std::array<Term, Terms>& terms,
+                   double impulse)
+        : m_size(size),
+          m_window(window),
+          m_terms(terms),
+          m_impulse(impulse)
+    {
+        assert(size >= SincFilter::MinimumSize && size % 2 == 1);
+    }
+
+    auto size() const -> size_t
+    {
+        return m_size;
+    }
+
+    auto window() const -> Window
+    {
+        return m_window;
+    }
+
+    auto terms() const -> const std::array<Term, Terms>&
+    {
+        return m_terms;
+    }
+
+    auto impulse() const -> double
+    {
+        return m_impulse;
+    }
+
+    template <size_t OtherTerms>
+    auto operator+(const SincExpression<OtherTerms>& rhs) const
+        -> SincExpression<Terms + OtherTerms>
+    {
+        return combine(rhs, 1.0);
+    }
+
+    template <size_t OtherTerms>
+    auto operator-(const SincExpression<OtherTerms>& rhs) const
+        -> SincExpression<Terms + OtherTerms>
+    {
+        return combine(rhs, -1.0);
+    }
+
+    auto operator~() const -> SincExpression
+    {
+        auto terms = m_terms;
+
+        for (auto& term : terms)
+            term.weight = -term.weight;
+
+        return { m_size, m_window, terms, 1.0 - m_impulse };
+    }
+
+    // Writes the coefficients, coeffs must hold size() values. Expressions of more than two
+    // terms take (Terms - 2) * (size() + 1) / 2 values of scratch memory from the resource.
+    void evaluate(std::span<double> coeffs,
+                  std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+    {
+        assert(coeffs.size() == m_size);
+
+        static constexpr size_t Block = SincFilter::RecurrenceInterval;
+
+        const size_t half = (m_size + 1) / 2;
+        const size_t center = half - 1;
+
+        std::pmr::vector<double> scratch((Terms > 2 ? Terms - 2 : 0) * half, resource);
+
+        // Windowed sinc value n < half of term j. The second term is stored mirrored in the
+        // upper half, except for its center value.
+        double secondCenter = 0.0;
+
+        const auto value = [&](size_t j, size_t n) -> double& {
+            if (j == 0)
+                return coeffs[n];
+
+            if (j == 1)
+                return n == center ? secondCenter : coeffs[m_size - 1 - n];
+
+            return scratch[(j - 2) * half + n];
+        };
+
+        std::array<double, Block> windows;
+        std::array<double, Block> sincs;
+
+        // Each term is normalized to unit gain like SincFilter::lowPass()
+        std::array<double, Terms> gains = {};
+
+        for (size_t first = 0; first < half; first += Block)
+        {
+            const size_t count = std::min(Block, half - first);
+            SincFilter::windowValues(m_window, m_size, first, std::span(windows).first(count));
+
+            for (size_t j = 0; j < Terms; ++j)
+            {
+                SincFilter::sincValues(m_terms[j].fc, m_size, first,
+                                       std::span(sincs).first(count));
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const double windowed = windows[i] * sincs[i];
+                    const double mirrored = first + i < center ? 2.0 : 1.0;
+
+                    value(j, first + i) = windowed;
+                    gains[j] += mirrored * windowed;
+                }
+            }
+        }
+
+        std::array<double, Terms> factors;
+
+        for (size_t j = 0; j < Terms; ++j)
+            factors[j] = m_terms[j].weight / gains[j];
+
+        // Term 0 is replaced by the sum in place, the upper half is overwritten by the mirror
+        // copy afterwards
+        for (size_t n = 0; n < half; ++n)
+        {
+            double sum = 0.0;
+
+            for (size_t j = 0; j < Terms; ++j)
+                sum += factors[j] * value(j, n);
+
+            coeffs[n] = sum;
+        }
+
+        coeffs[center] += m_impulse;
+        std::copy_n(coeffs.begin(), center, coeffs.rbegin());
+    }
+
+    // Allocates the coefficients of the filter once and evaluates into them
+    auto filter(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+        -> SincFilter
+    {
+        SincFilter out(m_size, resource);
+        evaluate(out.m_coeffs, resource);
+        out.detectSymmetry();
+        return out;
+    }
+
+    operator SincFilter() const
+    {
+        return filter();
+    }
+
+private:
+    template <size_t OtherTerms>
+    auto combine(const SincExpression<OtherTerms>& rhs, double sign) const
+        -> SincExpression<Terms + OtherTerms>
+    {
+        assert(rhs.size() == m_size && rhs.window() == m_window);
+
+        std::array<typename SincExpression<Terms + OtherTerms>::Term, Terms + OtherTerms> terms;
+
+        for (size_t j = 0; j < Terms; ++j)
+            terms[j] = { m_terms[j].fc, m_terms[j].weight };
+
+        for (size_t j = 0; j < OtherTerms; ++j)
+            terms[Terms + j] = { rhs.terms()[j].fc, sign * rhs.terms()[j].weight };
+
+        return { m_size, m_window, terms, m_impulse + sign * rhs.impulse() };
+    }
+
+private:
+    size_t m_size;
+    Window m_window;
+    std::array<Term, Terms> m_terms;
+    double m_impulse;
+};
+
+// Factory functions matching those of SincFilter
+
+inline auto lowPassExpression(size_t size, double fc,
+                              SincFilter::Window window = SincFilter::DefaultWindowType)
+    -> SincExpression<1>
+{
+    assert(fc > SincFilter::MinimumFrequency && fc < SincFilter::MaximumFrequency);
+    return { size, window, {{ { fc, 1.0 } }}, 0.0 };
+}
+
+inline auto highPassExpression(size_t size, double fc,
+                               SincFilter::Window window = SincFilter::DefaultWindowType)
+    -> SincExpression<1>
+{
+    return ~lowPassExpression(size, fc, window);
+}
+
+inline auto stopBandExpression(size_t size, double fl, double fh,
+                               SincFilter::Window window = SincFilter::DefaultWindowType)
+    -> SincExpression<2>
+{
+    assert(fl < fh);
+    return lowPassExpression(size, fl, window) + highPassExpression(size, fh, window);
+}
+
+inline auto bandPassExpression(size_t size, double fl, double fh,
+                               SincFilter::Window window = SincFilter::DefaultWindowType)
+    -> SincExpression<2>
+{
+    return ~stopBandExpression(size, fl, fh, window);
+}
@@ -33,9 +33,24 @@
 
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <span>
 #include <vector>
 
+class FftConvolver;
+class FilterWorkspace;
+class ThreadPool;
+
+template <size_t Terms>
+class SincExpression;
+
+// Windowed-sinc FIR filter. Coefficients are allocated from the memory resource passed to the
+// factory functions, results of the operators use the resource of the left operand. Copies use
+// the default resource like std::pmr containers.
 class SincFilter
 {
 public:
@@ -48,45 +63,305 @@ public:
     {
         None,
         Blackman,
-        Hamming
+        Hamming,
+        Kaiser
     };
 
     static constexpr auto DefaultWindowType = WindowType::None;
 
+    // Comparable to the Blackman window, with a stopband attenuation of about 90 dB
+    static constexpr double DefaultKaiserBeta = 8.6;
+
+    // Window type and shape parameter. Only the Kaiser window has a parameter, beta, which
+    // trades a wider transition band for a higher stopband attenuation.
+    struct Window
+    {
+        constexpr Window(WindowType type = DefaultWindowType)
+            : Window(type, type == WindowType::Kaiser ? DefaultKaiserBeta : 0.0) {}
+
+        constexpr Window(WindowType type, double beta)
+            : type(type), beta(beta) {}
+
+        static constexpr auto kaiser(double beta) -> Window
+        {
+            return { WindowType::Kaiser, beta };
+        }
+
+        auto operator==(const Window&) const -> bool = default;
+
+        WindowType type;
+        double beta;
+    };
+
+    enum class Method
+    {
+        Automatic,
+        Direct,
+        Fft
+    };
+
+    static constexpr auto DefaultMethod = Method::Automatic;
+
+    // Part of the convolution that is computed: all input.size() + size() - 1 samples, the
+    // input.size() samples centered on the filter delay, or the input.size() - size() + 1
+    // samples that do not depend on the zeros outside the input
+    enum class Mode
+    {
+        Full,
+        Same,
+        Valid
+    };
+
+    static constexpr auto DefaultMode = Mode::Full;
+
+    enum class Layout
+    {
+        Interleaved, // frame by frame, one sample per channel
+        Planar       // channel by channel
+    };
+
 public:
+    // Filter with the given coefficients, e.g. from SincDesign. The size must be odd.
+    explicit SincFilter(std::span<const double> coeffs,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
     auto size() const -> size_t;
-    auto coefficients() const -> const std::vector<double>&;
+    auto coefficients() const -> const std::pmr::vector<double>&;
+    auto resource() const -> std::pmr::memory_resource*;
+
+    // Linear-phase filters have symmetric coefficients, which the direct method exploits to
+    // save half of the multiplications. All filters built by the factory functions and the
+    // operators are symmetric.
+    auto isSymmetric() const -> bool;
+
+    auto outputSize(size_t inputSize, Mode mode = DefaultMode) const -> size_t;
+
+    // Offset of the first sample of the given mode within the full convolution
+    auto firstOutput(Mode mode) const -> size_t;
+
+    // Whether the automatic method chooses the FFT for a signal of the given size, which it
+    // does when that is estimated to need fewer operations
+    auto useFft(size_t inputSize) const -> bool;
+
+    // Convolver used by the FFT method, created on the first call. Thread-safe, concurrent first
+    // calls wait for one of them to create it.
+    auto fftConvolver() const -> const FftConvolver&;
+
+    // Output samples beyond outputSize() are set to zero
+    void apply(std::span<const double> input, std::span<double> output, double scale = 1.0,
+               Method method = DefaultMethod) const;
+
+    // Only the requested part is computed, the scale is applied with the result
+    void apply(std::span<const double> input, std::span<double> output, Mode mode,
+               double scale = 1.0, Method method = DefaultMethod) const;
+
+    // Splits the output into segments which are computed on the threads of the pool, each
+    // reading the size() - 1 input samples before it. Segments of the FFT method are aligned
+    // to pairs of FFT blocks, so both methods give results identical to the serial version.
+    void apply(ThreadPool& pool, std::span<const double> input, std::span<double> output,
+               Mode mode = DefaultMode, double scale = 1.0,
+               Method method = DefaultMethod) const;
+
+    // Same with scratch memory taken from the workspace, so that repeated calls allocate nothing
+    // once it has grown to the sizes needed. With a workspace made for this filter, which also
+    // creates the FFT convolver, no call allocates at all.
+    void apply(FilterWorkspace& workspace, std::span<const double> input,
+               std::span<double> output, Mode mode = DefaultMode, double scale = 1.0,
+               Method method = DefaultMethod) const;
+
+    // Same mode with the direct method, overwriting the signal. Only size() - 1 input samples
+    // and a chunk are buffered, independent of the signal size.
+    void applyInPlace(std::span<double> signal, double scale = 1.0) const;
+    void applyInPlace(FilterWorkspace& workspace, std::span<double> signal,
+                      double scale = 1.0) const;
+
+    // Filters all channels of a multichannel signal with the direct method. Interleaved groups
+    // of channels are processed together, so each coefficient is loaded once per frame for the
+    // whole group. In planar layout, each output channel holds input.size() / channels +
+    // size() - 1 samples.
+    void applyChannels(std::span<const double> input, std::span<double> output, size_t channels,
+                       Layout layout, double scale = 1.0) const;
+
+    // Filters many independent signals of signalSize samples, stored one after another, with the
+    // direct method. Output holds outputSize(signalSize, mode) samples per signal. Coefficients
+    // are prepared once per call and each signal is zero-padded into a reused buffer, so a
+    // single kernel call covers all of its outputs including the edges.
+    void applyBatch(std::span<const double> input, size_t signalSize, std::span<double> output,
+                    Mode mode = DefaultMode, double scale = 1.0) const;
 
-    void apply(std::span<const double> input, std::span<double> output, double scale = 1.0);
+    // Same with blocks of signals distributed over the threads of the pool
+    void applyBatch(ThreadPool& pool, std::span<const double> input, size_t signalSize,
+                    std::span<double> output, Mode mode = DefaultMode, double scale = 1.0) const;
 
     auto operator+(const SincFilter& rhs) const -> SincFilter;
     auto operator-(const SincFilter& rhs) const -> SincFilter;
     auto operator*(const SincFilter& rhs) const -> SincFilter;
     auto operator~() const -> SincFilter;
 
-    static auto lowPass(size_t size, double fc,
-                        WindowType window = DefaultWindowType) -> SincFilter;
+    // Filter of equal size with the same magnitude response and minimum phase, computed from
+    // the real cepstrum of the magnitude response. Its energy is concentrated at the start of
+    // the impulse response, which cuts the delay of the passband to a fraction of the
+    // (size() - 1) / 2 samples of a linear-phase filter. The coefficients are not symmetric,
+    // so the direct method needs twice as many multiplications.
+    auto minimumPhase() const -> SincFilter;
 
-    static auto highPass(size_t size, double fc,
-                         WindowType window = DefaultWindowType) -> SincFilter;
+    static auto lowPass(size_t size, double fc, Window window = DefaultWindowType,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        -> SincFilter;
 
-    static auto stopBand(size_t size, double fl, double fh,
-                         WindowType window = DefaultWindowType) -> SincFilter;
+    static auto highPass(size_t size, double fc, Window window = DefaultWindowType,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        -> SincFilter;
 
-    static auto bandPass(size_t size, double fl, double fh,
-                         WindowType window = DefaultWindowType) -> SincFilter;
+    static auto stopBand(size_t size, double fl, double fh, Window window = DefaultWindowType,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        -> SincFilter;
+
+    static auto bandPass(size_t size, double fl, double fh, Window window = DefaultWindowType,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        -> SincFilter;
+
+    // Kaiser-window designs of the smallest odd size meeting a specification: transition bands
+    // of the given width centered on the cutoff frequencies, outside of which the amplitude
+    // response deviates from the ideal one by at most 10^(-attenuationDb / 20) in both pass and
+    // stop bands. The size is estimated with Kaiser's formula and then adjusted by checking the
+    // frequency response. Attenuations up to 200 dB are supported. Empty if a band edge lies
+    // outside 0 ... 0.5, if two transition bands overlap, or if the specification cannot be
+    // met with up to twice the estimated size or 2^20 coefficients.
+    static auto lowPass(double fc, double transitionWidth, double attenuationDb)
+        -> std::optional<SincFilter>;
+
+    static auto highPass(double fc, double transitionWidth, double attenuationDb)
+        -> std::optional<SincFilter>;
+
+    static auto stopBand(double fl, double fh, double transitionWidth, double attenuationDb)
+        -> std::optional<SincFilter>;
+
+    static auto bandPass(double fl, double fh, double transitionWidth, double attenuationDb)
+        -> std::optional<SincFilter>;
+
+    // Whether the band edges of ascending cutoff frequencies, each -/+ transitionWidth / 2, lie
+    // strictly between 0 and 0.5 without overlapping, as the designs above require
+    static auto validBandEdges(std::span<const double> cutoffs, double transitionWidth) -> bool;
+
+    // Kaiser's empirical formulas for the window parameter and the filter size
+    static auto kaiserBeta(double attenuationDb) -> double;
+    static auto kaiserSize(double transitionWidth, double attenuationDb) -> size_t;
+
+    // Modified Bessel function of the first kind and order zero from its power series, which
+    // defines the Kaiser window. Constexpr for SincDesign.
+    static constexpr auto besselI0(double x) -> double
+    {
+        const double q = x*x / 4.0;
+
+        double term = 1.0;
+        double sum = 1.0;
+
+        for (double k = 1.0; term > sum * 1e-17; k += 1.0)
+        {
+            term *= q / (k*k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Direct method with caller-owned symmetric coefficients, e.g. an array from SincDesign.
+    // Neither the coefficients are copied nor is any memory allocated.
+    static void applyCoefficients(std::span<const double> coeffs, std::span<const double> input,
+                                  std::span<double> output, Mode mode = DefaultMode,
+                                  double scale = 1.0);
 private:
-    SincFilter(size_t size);
-    SincFilter(size_t size, double fc, WindowType window);
+    static constexpr size_t ChannelGroupSize = 8;
+    static constexpr size_t ChunkSize = 256;
+
+private:
+    template <size_t Terms>
+    friend class SincExpression;
+
+    friend class FilterWorkspace;
+
+    SincFilter(size_t size, std::pmr::memory_resource* resource);
+    SincFilter(size_t size, double fc, Window window, std::pmr::memory_resource* resource);
 
-    void blackman();
-    void hamming();
+    // Unnormalized sinc and window values for the coefficients first ... first + values.size()
+    // of a filter. Sincs and cosine-sum windows use rotation recurrences which are reseeded with
+    // exact values every RecurrenceInterval coefficients. Compared to evaluating std::sin and
+    // std::cos for every coefficient, normalized designs deviate by less than 1e-14 of the
+    // largest coefficient up to a million taps and by about 1e-13 at ten million taps.
+    static constexpr size_t RecurrenceInterval = 64;
+
+    static void sincValues(double fc, size_t size, size_t first, std::span<double> values);
+    static void windowValues(Window window, size_t size, size_t first,
+                             std::span<double> values);
+
+    // Sines and cosines of phase + i * step for i < count, either output may be null
+    static void rotate(double phase, double step, double* sines, double* cosines, size_t count);
 
     void normalize();
 
+    void symmetrize();
+    void detectSymmetry();
+
+    // Resolves the automatic method and creates the FFT convolver if needed
+    auto prepare(size_t inputSize, Method method) const -> Method;
+
     static void convolve(std::span<const double> in1, std::span<const double> in2,
                          std::span<double> out);
 
+    // Coefficients in reverse order multiplied by scale, either the own coefficients if they
+    // can be used as they are or a copy in the workspace
+    auto scaledCoefficients(double scale, FilterWorkspace& workspace) const -> const double*;
+
+    // Output size and first output of a mode for the given number of taps
+    static auto outputSize(size_t taps, size_t inputSize, Mode mode) -> size_t;
+    static auto firstOutput(size_t taps, Mode mode) -> size_t;
+
+    // Samples first ... first + output.size() - 1 of the full convolution using the direct
+    // method with the given scaled coefficients. Symmetric coefficients are their own reverse,
+    // so the first half of them is passed to the symmetric kernel.
+    static void convolveRange(std::span<const double> input, size_t first,
+                              std::span<double> output, const double* reversed, size_t taps,
+                              bool symmetric);
+
+    // Filters signals first ... first + count - 1 of a batch with prepared coefficients
+    void filterSignals(std::span<const double> input, size_t signalSize,
+                       std::span<double> output, Mode mode, const double* reversed,
+                       size_t first, size_t count) const;
+
 private:
-    std::vector<double> m_coeffs;
+    std::pmr::vector<double> m_coeffs;
+    bool m_symmetric = false;
+
+    // Created on first use of the FFT method, immutable and therefore shared between copies. The
+    // pointer is guarded, so that a const filter can be applied by several threads at once.
+    struct SharedConvolver
+    {
+        SharedConvolver() = default;
+
+        SharedConvolver(const SharedConvolver& other)
+            : pointer(other.get())
+        {
+        }
+
+        auto operator=(const SharedConvolver& other) -> SharedConvolver&
+        {
+            auto copy = other.get();
+
+            std::lock_guard lock(mutex);
+            pointer = std::move(copy);
+            return *this;
+        }
+
+        auto get() const -> std::shared_ptr<const FftConvolver>
+        {
+            std::lock_guard lock(mutex);
+            return pointer;
+        }
+
+        mutable std::mutex mutex;
+        std::shared_ptr<const FftConvolver> pointer;
+    };
+
+    mutable SharedConvolver m_fftConvolver;
 };
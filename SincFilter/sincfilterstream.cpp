@@ -0,0 +1,112 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#include "sincfilterstream.h"
+#include "convolutionkernel.h"
+#include "sincfilter.h"
+
+#include <algorithm>
+#include <cassert>
+
+// ---------------------------------------------------------------------------------------------- //
+
+SincFilterStream::SincFilterStream(const SincFilter& filter, double scale)
+    : SincFilterStream(filter.coefficients(), scale)
+{
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+SincFilterStream::SincFilterStream(std::span<const double> coeffs, double scale)
+    : m_reversed(coeffs.rbegin(), coeffs.rend()),
+      m_chunkSize(std::max(DefaultChunkSize, coeffs.size()))
+{
+    assert(!coeffs.empty());
+
+    // Scale is folded into the coefficients
+    if (scale != 1.0)
+    {
+        std::transform(m_reversed.begin(), m_reversed.end(), m_reversed.begin(),
+                       [scale](double c) { return scale*c; });
+    }
+
+    // The chunk size is at least the history size, so moving the history after each chunk
+    // costs less than filtering it
+    m_buffer.resize(m_reversed.size() - 1 + m_chunkSize, 0.0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto SincFilterStream::size() const -> size_t
+{
+    return m_reversed.size();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto SincFilterStream::delay() const -> size_t
+{
+    return (m_reversed.size() - 1) / 2;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void SincFilterStream::process(std::span<const double> input, std::span<double> output)
+{
+    assert(output.size() >= input.size());
+
+    const size_t history = m_reversed.size() - 1;
+
+    while (!input.empty())
+    {
+        const size_t count = std::min(input.size(), m_chunkSize);
+
+        std::copy_n(input.begin(), count, m_buffer.begin() + history);
+
+        ConvolutionKernel::correlate(m_buffer.data(), m_reversed.data(), m_reversed.size(),
+                                     output.data(), count);
+
+        std::copy_n(m_buffer.begin() + count, history, m_buffer.begin());
+
+        input = input.subspan(count);
+        output = output.subspan(count);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void SincFilterStream::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0);
+}
+
+// ---------------------------------------------------------------------------------------------- //
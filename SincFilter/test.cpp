@@ -32,15 +32,1270 @@
 // ============================================================================================== //
 
 #include "sincfilter.h"
+#include "convolutionkernel.h"
+#include "designcache.h"
+#include "fft.h"
+#include "fftconvolver.h"
+#include "filterworkspace.h"
+#include "fractionalresampler.h"
+#include "polyphasefilter.h"
+#include "samplefile.h"
+#include "sincdesign.h"
+#include "sincexpression.h"
+#include "sincfilterstream.h"
+#include "threadpool.h"
+#include "typedfilter.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <new>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 // ---------------------------------------------------------------------------------------------- //
 
+// Global allocations are counted to verify that hot paths do not allocate
+static std::atomic<size_t> allocations = 0;
+
+auto operator new(size_t size) -> void*
+{
+    ++allocations;
+
+    if (void* p = std::malloc(size > 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// Memory resources use the aligned forms
+auto operator new(size_t size, std::align_val_t alignment) -> void*
+{
+    ++allocations;
+
+    const auto align = static_cast<size_t>(alignment);
+    const auto rounded = (std::max<size_t>(size, 1) + align - 1) / align * align;
+
+    if (void* p = std::aligned_alloc(align, rounded))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static auto maximumDifference(std::span<const double> a, std::span<const double> b) -> double
+{
+    double difference = 0.0;
+
+    for (size_t i = 0; i < std::min(a.size(), b.size()); ++i)
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+
+    return difference;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static auto makeTestSignal(size_t size) -> std::vector<double>
+{
+    std::vector<double> signal(size);
+
+    for (size_t i = 0; i < size; ++i)
+        signal[i] = std::sin(0.01 * i) + 0.1 * static_cast<double>(i % 7);
+
+    return signal;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testConvolutionKernel()
+{
+    const auto input = makeTestSignal(300);
+    const auto reversed = makeTestSignal(37);
+
+    std::vector<double> output(input.size() - reversed.size() + 1);
+    ConvolutionKernel::correlate(input.data(), reversed.data(), reversed.size(),
+                                 output.data(), output.size());
+
+    for (size_t i = 0; i < output.size(); ++i)
+    {
+        double expected = 0.0;
+
+        for (size_t k = 0; k < reversed.size(); ++k)
+            expected += input[i + k] * reversed[k];
+
+        assert(std::abs(output[i] - expected) < 1e-12);
+    }
+
+    // Splitting the output range must not change any result
+    std::vector<double> split(output.size());
+
+    for (size_t i = 0; i < split.size(); i += 7)
+    {
+        ConvolutionKernel::correlate(&input[i], reversed.data(), reversed.size(),
+                                     &split[i], std::min<size_t>(7, split.size() - i));
+    }
+
+    assert(split == output);
+
+    // Symmetric coefficients give the same result from half of them
+    std::vector<double> symmetric(reversed.begin(), reversed.begin() + reversed.size() / 2 + 1);
+    symmetric.insert(symmetric.end(), symmetric.rbegin() + 1, symmetric.rend());
+
+    ConvolutionKernel::correlate(input.data(), symmetric.data(), symmetric.size(),
+                                 output.data(), output.size());
+
+    ConvolutionKernel::correlateSymmetric(input.data(), symmetric.data(), symmetric.size(),
+                                          split.data(), split.size());
+
+    assert(maximumDifference(output, split) < 1e-12);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testFftConvolution()
+{
+    [[maybe_unused]] static constexpr double Tolerance = 1e-12;
+
+    const auto signal = makeTestSignal(5000);
+    const auto filter = SincFilter::lowPass(255, 0.1, SincFilter::WindowType::Blackman);
+
+    assert(filter.isSymmetric() && (filter * ~filter).isSymmetric());
+
+    const size_t outputSize = signal.size() + filter.size() - 1;
+
+    std::vector<double> direct(outputSize);
+    filter.apply(signal, direct, 1.0, SincFilter::Method::Direct);
+
+    std::vector<double> fft(outputSize);
+    filter.apply(signal, fft, 1.0, SincFilter::Method::Fft);
+
+    assert(maximumDifference(direct, fft) < Tolerance);
+
+    // Streaming output is delayed by one block but otherwise identical
+    FftConvolver convolver(filter.coefficients());
+    std::vector<double> streamed(outputSize + convolver.blockSize());
+
+    for (size_t position = 0; position < streamed.size(); position += 100)
+    {
+        const size_t count = std::min<size_t>(100, streamed.size() - position);
+        std::vector<double> block(count, 0.0);
+
+        for (size_t i = 0; i < count && position + i < signal.size(); ++i)
+            block[i] = signal[position + i];
+
+        convolver.process(block, std::span(streamed).subspan(position, count));
+    }
+
+    assert(maximumDifference(direct, std::span(streamed).subspan(convolver.blockSize())) <
+           Tolerance);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testStreaming()
+{
+    const auto signal = makeTestSignal(3000);
+    auto filter = SincFilter::bandPass(101, 0.05, 0.15, SincFilter::WindowType::Hamming);
+
+    std::vector<double> expected(signal.size() + filter.size() - 1);
+    filter.apply(signal, expected, 1.0, SincFilter::Method::Direct);
+
+    // Blocks of varying size, filtered in place
+    SincFilterStream stream(filter);
+    std::vector<double> streamed = signal;
+
+    for (size_t position = 0, count = 1; position < streamed.size(); position += count)
+    {
+        count = std::min((count * 5 + 3) % 700, streamed.size() - position);
+
+        auto block = std::span(streamed).subspan(position, count);
+        stream.process(block, block);
+    }
+
+    assert(maximumDifference(expected, streamed) < 1e-15);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testPolyphase()
+{
+    [[maybe_unused]] static constexpr double Tolerance = 1e-13;
+    static constexpr size_t Factor = 3;
+
+    const auto signal = makeTestSignal(2000);
+    auto filter = SincFilter::lowPass(65, 0.5 / Factor, SincFilter::WindowType::Blackman);
+
+    std::vector<double> full(signal.size() + filter.size() - 1);
+    filter.apply(signal, full, 1.0, SincFilter::Method::Direct);
+
+    // Decimation keeps every Factor-th sample of the full convolution
+    PolyphaseDecimator decimator(filter, Factor);
+
+    std::vector<double> decimated(decimator.outputSize(signal.size()));
+    decimator.apply(signal, decimated);
+
+    for (size_t i = 0; i < decimated.size(); ++i)
+        assert(std::abs(decimated[i] - full[i * Factor]) < Tolerance);
+
+    std::vector<double> streamed;
+
+    for (size_t position = 0, count = 1; position < signal.size(); position += count)
+    {
+        count = std::min((count * 7 + 2) % 900, signal.size() - position);
+
+        std::vector<double> block(count / Factor + 1);
+        const size_t written = decimator.process(std::span(signal).subspan(position, count), block);
+
+        streamed.insert(streamed.end(), block.begin(), block.begin() + written);
+    }
+
+    assert(streamed.size() == (signal.size() + Factor - 1) / Factor);
+    assert(maximumDifference(streamed, std::span(decimated).first(streamed.size())) < Tolerance);
+
+    // Interpolation equals filtering the zero-stuffed signal, scaled by Factor
+    std::vector<double> stuffed(signal.size() * Factor, 0.0);
+
+    for (size_t i = 0; i < signal.size(); ++i)
+        stuffed[i * Factor] = signal[i];
+
+    std::vector<double> expected(stuffed.size() + filter.size() - 1);
+    filter.apply(stuffed, expected, Factor, SincFilter::Method::Direct);
+
+    PolyphaseInterpolator interpolator(filter, Factor);
+
+    std::vector<double> interpolated(interpolator.outputSize(signal.size()));
+    interpolator.apply(signal, interpolated);
+
+    assert(interpolated.size() == expected.size());
+    assert(maximumDifference(expected, interpolated) < Tolerance);
+
+    std::vector<double> upsampled(signal.size() * Factor);
+
+    for (size_t position = 0, count = 1; position < signal.size(); position += count)
+    {
+        count = std::min((count * 5 + 3) % 700, signal.size() - position);
+
+        interpolator.process(std::span(signal).subspan(position, count),
+                             std::span(upsampled).subspan(position * Factor, count * Factor));
+    }
+
+    assert(maximumDifference(upsampled, std::span(expected).first(upsampled.size())) < Tolerance);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testResampling()
+{
+    static constexpr double TwoPi = 2.0 * 3.14159265358979323846;
+    static constexpr double Frequency = 0.03; // relative to the input rate
+
+    for (double ratio : { 48000.0 / 44100.0, 44100.0 / 48000.0, 0.5 })
+    {
+        std::vector<double> signal(20000);
+
+        for (size_t i = 0; i < signal.size(); ++i)
+            signal[i] = 0.25 + std::sin(TwoPi * Frequency * static_cast<double>(i));
+
+        FractionalResampler resampler(ratio);
+
+        std::vector<double> resampled(resampler.maximumOutputSize(signal.size()));
+        resampled.resize(resampler.process(signal, resampled));
+
+        // Output sample k lies at input position k / ratio, skip the start-up transient
+        for (size_t k = 100; k < resampled.size(); ++k)
+        {
+            const double position = static_cast<double>(k) / ratio;
+            [[maybe_unused]] const double expected = 0.25 + std::sin(TwoPi * Frequency * position);
+
+            assert(std::abs(resampled[k] - expected) < 1e-3);
+        }
+
+        // Blocks of varying size produce the same samples
+        resampler.reset();
+        std::vector<double> streamed;
+
+        for (size_t position = 0, count = 1; position < signal.size(); position += count)
+        {
+            count = std::min((count * 5 + 3) % 700, signal.size() - position);
+
+            std::vector<double> block(resampler.maximumOutputSize(count));
+            const size_t written = resampler.process(std::span(signal).subspan(position, count),
+                                                     block);
+
+            streamed.insert(streamed.end(), block.begin(), block.begin() + written);
+        }
+
+        assert(streamed == resampled);
+    }
+
+    // When downsampling by 10, the kernel is ten times as wide, so that a tone just above the
+    // output Nyquist frequency of 0.05 is rejected rather than aliased
+    FractionalResampler decimator(0.1);
+    assert(decimator.taps() == 10 * FractionalResampler::DefaultTaps);
+
+    std::vector<double> tone(40000);
+
+    for (size_t i = 0; i < tone.size(); ++i)
+        tone[i] = std::sin(TwoPi * 0.07 * static_cast<double>(i));
+
+    std::vector<double> decimated(decimator.maximumOutputSize(tone.size()));
+    decimated.resize(decimator.process(tone, decimated));
+
+    for (size_t k = 100; k < decimated.size(); ++k)
+        assert(std::abs(decimated[k]) < 1e-3);
+
+    // Drift correction changes the rate for subsequent samples only
+    FractionalResampler resampler(1.0);
+
+    std::vector<double> ones(1000, 1.0);
+    std::vector<double> output(resampler.maximumOutputSize(ones.size()));
+
+    [[maybe_unused]] const size_t first = resampler.process(ones, output);
+    resampler.setRatio(1.001);
+    [[maybe_unused]] const size_t second = resampler.process(ones, output);
+
+    assert(first == ones.size() - resampler.taps() / 2);
+    assert(second == 1001 || second == 1002);
+    assert(std::abs(output[second - 1] - 1.0) < 1e-3);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testMultichannel()
+{
+    const auto filter = SincFilter::lowPass(41, 0.2, SincFilter::WindowType::Hamming);
+    const size_t frames = 700;
+
+    for (size_t channels : { 1, 5, 19 })
+    {
+        const auto signal = makeTestSignal(frames * channels);
+        const size_t outputFrames = frames + filter.size() - 1;
+
+        std::vector<double> interleaved(frames * channels);
+
+        for (size_t c = 0; c < channels; ++c)
+        {
+            for (size_t i = 0; i < frames; ++i)
+                interleaved[i * channels + c] = signal[c * frames + i];
+        }
+
+        std::vector<double> planarOutput(outputFrames * channels);
+        filter.applyChannels(signal, planarOutput, channels, SincFilter::Layout::Planar, 0.5);
+
+        std::vector<double> interleavedOutput(outputFrames * channels);
+        filter.applyChannels(interleaved, interleavedOutput, channels,
+                             SincFilter::Layout::Interleaved, 0.5);
+
+        for (size_t c = 0; c < channels; ++c)
+        {
+            auto single = filter;
+            std::vector<double> expected(outputFrames);
+
+            single.apply(std::span(signal).subspan(c * frames, frames), expected, 0.5,
+                         SincFilter::Method::Direct);
+
+            for (size_t i = 0; i < outputFrames; ++i)
+            {
+                assert(std::abs(planarOutput[c * outputFrames + i] - expected[i]) < 1e-14);
+                assert(std::abs(interleavedOutput[i * channels + c] - expected[i]) < 1e-14);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testSampleTypes()
+{
+    const auto signal = makeTestSignal(1500);
+    auto filter = SincFilter::bandPass(63, 0.1, 0.3, SincFilter::WindowType::Blackman);
+
+    std::vector<double> expected(signal.size() + filter.size() - 1);
+    filter.apply(signal, expected, 1.0, SincFilter::Method::Direct);
+
+    // Single precision
+    const std::vector<float> floatSignal(signal.begin(), signal.end());
+    std::vector<float> floatOutput(expected.size());
+
+    TypedFilter<float>(filter).apply(floatSignal, floatOutput);
+
+    for (size_t i = 0; i < expected.size(); ++i)
+        assert(std::abs(floatOutput[i] - expected[i]) < 1e-5);
+
+    // Fixed point, the error is dominated by the quantization of the coefficients
+    const auto testFixedPoint = [&](auto sample, [[maybe_unused]] double tolerance) {
+        using Sample = decltype(sample);
+
+        std::vector<Sample> fixedSignal;
+
+        for (double x : signal)
+            fixedSignal.push_back(Sample::fromDouble(0.5 * x));
+
+        std::vector<Sample> fixedOutput(expected.size());
+        TypedFilter<Sample>(filter).apply(fixedSignal, fixedOutput);
+
+        for (size_t i = 0; i < expected.size(); ++i)
+            assert(std::abs(fixedOutput[i].toDouble() - 0.5 * expected[i]) < tolerance);
+    };
+
+    testFixedPoint(Q15(), 2e-4);
+    testFixedPoint(Q31(), 1e-7);
+
+    // Results outside the range saturate instead of wrapping around
+    const std::vector<double> gain = { 0.9, 0.9, 0.9 };
+    const std::vector<Q15> halves(10, Q15::fromDouble(0.5));
+    std::vector<Q15> saturated(12);
+
+    TypedFilter<Q15>(gain).apply(halves, saturated);
+
+    assert(saturated[0] == Q15::fromDouble(0.45));
+    assert(saturated[5].value == Q15::Maximum);
+
+    // Q31 products are rounded once at the end instead of being truncated on every tap, which
+    // would sum to -64 instead of -32 here
+    const std::vector<double> halfTaps(64, 0.5);
+    const std::vector<Q31> smallest(100, Q31{ -1 });
+    std::vector<Q31> rounded(163);
+
+    TypedFilter<Q31>(halfTaps).apply(smallest, rounded);
+
+    assert(rounded[80].value == -32);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testExpressions()
+{
+    static constexpr auto Window = SincFilter::WindowType::Blackman;
+
+    const auto lowPass = SincFilter::lowPass(81, 0.1, Window);
+    const auto highPass = ~SincFilter::lowPass(81, 0.3, Window);
+
+    // Same algebra as with filter objects, evaluated without temporaries
+    const SincFilter stopBand = lowPassExpression(81, 0.1, Window) +
+                                highPassExpression(81, 0.3, Window);
+
+    const SincFilter bandPass = ~stopBandExpression(81, 0.1, 0.3, Window);
+    const SincFilter difference = lowPassExpression(81, 0.3, Window) -
+                                  lowPassExpression(81, 0.1, Window);
+
+    assert(maximumDifference(stopBand.coefficients(), (lowPass + highPass).coefficients()) <
+           1e-15);
+
+    assert(maximumDifference(bandPass.coefficients(), (~(lowPass + highPass)).coefficients()) <
+           1e-15);
+
+    assert(maximumDifference(difference.coefficients(), bandPass.coefficients()) < 1e-15);
+    assert(stopBand.isSymmetric() && bandPass.isSymmetric());
+
+    // Terms beyond the second are kept in scratch memory
+    const SincFilter threeTerms = stopBandExpression(81, 0.1, 0.3, Window) -
+                                  lowPassExpression(81, 0.05, Window);
+
+    assert(maximumDifference(threeTerms.coefficients(),
+                             (lowPass + highPass - SincFilter::lowPass(81, 0.05, Window))
+                                 .coefficients()) < 1e-15);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testDesignCache()
+{
+    static constexpr auto Window = SincFilter::WindowType::Hamming;
+
+    DesignCache cache(2);
+
+    const auto first = cache.lowPass(101, 0.1, Window);
+    const auto second = cache.lowPass(101, 0.1, Window);
+
+    assert(first == second);
+    assert(first->coefficients() == SincFilter::lowPass(101, 0.1, Window).coefficients());
+
+    // The same frequency with another type or window is a different design
+    const auto highPass = cache.highPass(101, 0.1, Window);
+    assert(highPass != first);
+
+    // Evicts the high-pass filter, which is least recently used after this lookup
+    cache.lowPass(101, 0.1, Window);
+    cache.bandPass(101, 0.1, 0.2, Window);
+
+    assert(cache.size() == 2);
+    assert(cache.lowPass(101, 0.1, Window) == first);
+    assert(cache.highPass(101, 0.1, Window) != highPass);
+
+    [[maybe_unused]] const auto statistics = cache.statistics();
+    assert(statistics.hits == 3 && statistics.misses == 4 && statistics.evictions == 2);
+
+    // Concurrent lookups of a few designs
+    DesignCache shared;
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&shared] {
+            for (size_t i = 0; i < 200; ++i)
+                shared.stopBand(31 + 2 * (i % 5), 0.1, 0.2, Window);
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    assert(shared.size() == 5);
+    assert(shared.statistics().hits + shared.statistics().misses == 800);
+
+    // Cached designs are applied directly, the FFT convolver is created by whichever thread
+    // comes first
+    const auto cached = cache.lowPass(301, 0.05, Window);
+    const auto signal = makeTestSignal(20000);
+
+    std::vector<double> expected(cached->outputSize(signal.size()));
+    SincFilter::lowPass(301, 0.05, Window).apply(signal, expected, 1.0, SincFilter::Method::Fft);
+
+    std::array<std::vector<double>, 2> outputs;
+    std::vector<std::thread> users;
+
+    for (auto& output : outputs)
+    {
+        output.resize(expected.size());
+
+        users.emplace_back([&cached, &signal, &output] {
+            cached->apply(signal, output, 1.0, SincFilter::Method::Fft);
+        });
+    }
+
+    for (auto& user : users)
+        user.join();
+
+    assert(outputs[0] == expected && outputs[1] == expected);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testDesignAccuracy()
+{
+    static constexpr double TwoPi = 2.0 * 3.14159265358979323846;
+
+    // Reference design evaluating the trigonometric functions for every coefficient
+    const size_t size = 20001;
+    const double fc = 0.123;
+    const auto center = static_cast<double>(size - 1) / 2;
+
+    std::vector<double> reference(size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const double offset = static_cast<double>(i) - center;
+        const double phase = TwoPi * static_cast<double>(i) / (size - 1);
+
+        reference[i] = (offset == 0.0 ? TwoPi * fc : std::sin(TwoPi * fc * offset) / offset) *
+                       (0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+    }
+
+    const double sum = std::accumulate(reference.begin(), reference.end(), 0.0);
+
+    for (double& c : reference)
+        c /= sum;
+
+    const auto filter = SincFilter::lowPass(size, fc, SincFilter::WindowType::Blackman);
+    assert(maximumDifference(filter.coefficients(), reference) < 1e-14 * reference[size / 2]);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testOutputModes()
+{
+    static constexpr double Scale = 0.75;
+
+    auto filter = SincFilter::highPass(51, 0.2, SincFilter::WindowType::Hamming);
+    [[maybe_unused]] const size_t m = filter.size();
+
+    for (size_t signalSize : { 30, 51, 2000 })
+    {
+        const auto signal = makeTestSignal(signalSize);
+
+        std::vector<double> full(filter.outputSize(signal.size()));
+        filter.apply(signal, full, Scale, SincFilter::Method::Direct);
+
+        for (auto method : { SincFilter::Method::Direct, SincFilter::Method::Fft })
+        {
+            std::vector<double> same(filter.outputSize(signal.size(), SincFilter::Mode::Same));
+            filter.apply(signal, same, SincFilter::Mode::Same, Scale, method);
+
+            std::vector<double> valid(filter.outputSize(signal.size(), SincFilter::Mode::Valid));
+            filter.apply(signal, valid, SincFilter::Mode::Valid, Scale, method);
+
+            assert(same.size() == signal.size());
+            assert(valid.size() == (signalSize >= m ? signalSize - m + 1 : 0));
+
+            assert(maximumDifference(same, std::span(full).subspan((m - 1) / 2)) < 1e-14);
+            assert(maximumDifference(valid, std::span(full).subspan(m - 1)) < 1e-14);
+        }
+
+        // In place with a bounded history gives the same-mode result
+        std::vector<double> same(signal.size());
+        filter.apply(signal, same, SincFilter::Mode::Same, Scale, SincFilter::Method::Direct);
+
+        std::vector<double> inPlace = signal;
+        filter.applyInPlace(inPlace, Scale);
+
+        assert(maximumDifference(same, inPlace) < 1e-15);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testParallel()
+{
+    ThreadPool pool(4);
+
+    // Every index is processed exactly once, nested jobs run serially
+    std::vector<std::atomic<int>> calls(1000);
+
+    pool.parallelFor(calls.size(), [&](size_t i) {
+        pool.parallelFor(2, [&](size_t j) { calls[i] += static_cast<int>(j) + 1; });
+    });
+
+    assert(std::all_of(calls.begin(), calls.end(), [](const auto& c) { return c == 3; }));
+
+    // Uneven durations are balanced by stealing: only the first quarter of the indices, the
+    // initial range of the first worker, takes time, yet it is shared among the threads
+    std::vector<std::thread::id> executors(64);
+
+    pool.parallelFor(executors.size(), [&](size_t i) {
+        if (i < executors.size() / 4)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+        executors[i] = std::this_thread::get_id();
+    });
+
+    std::vector<std::thread::id> slowExecutors(executors.begin(),
+                                               executors.begin() + executors.size() / 4);
+    std::sort(slowExecutors.begin(), slowExecutors.end());
+
+    [[maybe_unused]] const auto distinct = std::unique(slowExecutors.begin(),
+                                                       slowExecutors.end()) - slowExecutors.begin();
+    assert(distinct >= 3);
+
+    // An exception thrown by a task ends the job and reaches the caller, after which the pool
+    // can be used again, also in parallel
+    [[maybe_unused]] bool thrown = false;
+
+    try
+    {
+        pool.parallelFor(calls.size(), [](size_t i) {
+            if (i == 500)
+                throw std::runtime_error("task failed");
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+
+    assert(thrown);
+
+    std::fill(executors.begin(), executors.end(), std::thread::id());
+    pool.parallelFor(executors.size(), [&](size_t i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        executors[i] = std::this_thread::get_id();
+    });
+
+    assert(std::none_of(executors.begin(), executors.end(),
+                        [](auto id) { return id == std::thread::id(); }));
+    assert(std::any_of(executors.begin(), executors.end(),
+                       [](auto id) { return id != std::this_thread::get_id(); }));
+
+    auto filter = SincFilter::bandPass(301, 0.1, 0.3, SincFilter::WindowType::Blackman);
+    const auto signal = makeTestSignal(250000);
+
+    for (auto method : { SincFilter::Method::Direct, SincFilter::Method::Fft })
+    {
+        for (auto mode : { SincFilter::Mode::Full, SincFilter::Mode::Same,
+                           SincFilter::Mode::Valid })
+        {
+            std::vector<double> serial(filter.outputSize(signal.size(), mode));
+            filter.apply(signal, serial, mode, 0.5, method);
+
+            std::vector<double> parallel(serial.size());
+            filter.apply(pool, signal, parallel, mode, 0.5, method);
+
+            assert(parallel == serial);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+// Amplitude response of a linear-phase filter at frequency f
+static auto amplitude(std::span<const double> coeffs, double f) -> double
+{
+    const double center = static_cast<double>(coeffs.size() - 1) / 2.0;
+    double sum = 0.0;
+
+    for (size_t k = 0; k < coeffs.size(); ++k)
+        sum += coeffs[k] * std::cos(2.0 * std::numbers::pi * f * (static_cast<double>(k) - center));
+
+    return sum;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testKaiserDesign()
+{
+    // The Kaiser window type uses the default beta
+    const auto kaiser = SincFilter::lowPass(101, 0.2, SincFilter::WindowType::Kaiser);
+    const auto explicitBeta = SincFilter::lowPass(101, 0.2, SincFilter::Window::kaiser(8.6));
+
+    assert(kaiser.coefficients() == explicitBeta.coefficients());
+    assert(kaiser.isSymmetric());
+
+    // Largest deviation from the ideal response within bands given as { low, high, gain }
+    [[maybe_unused]] const auto deviation = [](const SincFilter& filter,
+                              std::initializer_list<std::array<double, 3>> bands) {
+        static constexpr int Points = 2000;
+        double maximum = 0.0;
+
+        for (const auto& [low, high, gain] : bands)
+        {
+            for (int i = 0; i <= Points; ++i)
+            {
+                const double f = low + (high - low) * i / Points;
+                const double error = std::abs(amplitude(filter.coefficients(), f) - gain);
+
+                maximum = std::max(maximum, error);
+            }
+        }
+
+        return maximum;
+    };
+
+    static constexpr double Attenuation = 80.0;
+    static constexpr double Width = 0.02;
+
+    [[maybe_unused]] const double tolerance = std::pow(10.0, -Attenuation / 20.0);
+
+    [[maybe_unused]] const auto lowPassBands = { std::array{ 0.0, 0.19, 1.0 },
+                                                 std::array{ 0.21, 0.5, 0.0 } };
+
+    const auto lowPass = SincFilter::lowPass(0.2, Width, Attenuation).value();
+    assert(lowPass.size() % 2 == 1);
+    assert(deviation(lowPass, lowPassBands) <= 1.01 * tolerance);
+
+    // Kaiser's estimate is close to the size needed
+    assert(lowPass.size() <= SincFilter::kaiserSize(Width, Attenuation) + 4);
+
+    // A Blackman window of equal size does not reach the attenuation
+    const auto blackman = SincFilter::lowPass(lowPass.size(), 0.2,
+                                              SincFilter::WindowType::Blackman);
+    assert(deviation(blackman, lowPassBands) > tolerance);
+
+    [[maybe_unused]] const auto bandPassBands = { std::array{ 0.0, 0.09, 0.0 },
+                                                  std::array{ 0.11, 0.29, 1.0 },
+                                                  std::array{ 0.31, 0.5, 0.0 } };
+
+    const auto bandPass = SincFilter::bandPass(0.1, 0.3, Width, Attenuation).value();
+    assert(deviation(bandPass, bandPassBands) <= 1.01 * tolerance);
+
+    // Band edges outside 0 ... 0.5, overlapping transition bands and invalid parameters
+    const std::array rejected = {
+        SincFilter::lowPass(0.1, 0.4, 60.0),
+        SincFilter::lowPass(0.45, 0.2, 60.0),
+        SincFilter::highPass(0.2, 0.0, 60.0),
+        SincFilter::highPass(0.2, 0.02, 0.0),
+        SincFilter::bandPass(0.1, 0.12, 0.1, 60.0),
+        SincFilter::stopBand(0.3, 0.1, 0.02, 60.0)
+    };
+
+    assert(std::none_of(rejected.begin(), rejected.end(), [](const auto& f) { return f; }));
+
+    // The same band edge check is used by filterfile before designing
+    assert(SincFilter::validBandEdges(std::array{ 0.1, 0.3 }, 0.1));
+    assert(SincFilter::validBandEdges(std::array{ 0.45 }, 0.02));
+    assert(!SincFilter::validBandEdges(std::array{ 0.1 }, 0.4));
+    assert(!SincFilter::validBandEdges(std::array{ 0.45 }, 0.2));
+    assert(!SincFilter::validBandEdges(std::array{ 0.1, 0.12 }, 0.1));
+    assert(!SincFilter::validBandEdges(std::array{ 0.3, 0.1 }, 0.02));
+    assert(!SincFilter::validBandEdges(std::array{ 0.2 }, 0.0));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testMinimumPhase()
+{
+    const auto linear = SincFilter::lowPass(401, 0.1, SincFilter::WindowType::Blackman);
+    auto minimum = linear.minimumPhase();
+
+    assert(minimum.size() == linear.size() && !minimum.isSymmetric());
+
+    // Equal magnitude response, passband and transition within 0.1 %, stopband below -70 dB
+    std::vector<std::complex<double>> original(linear.coefficients().begin(),
+                                               linear.coefficients().end());
+    std::vector<std::complex<double>> converted(minimum.coefficients().begin(),
+                                                minimum.coefficients().end());
+
+    original.resize(4096);
+    converted.resize(4096);
+
+    const Fft fft(4096);
+    fft.forward(original);
+    fft.forward(converted);
+
+    for (size_t i = 0; i <= 2048; ++i)
+    {
+        [[maybe_unused]] const double expected = std::abs(original[i]);
+        [[maybe_unused]] const double actual = std::abs(converted[i]);
+
+        assert(std::abs(actual - expected) <= std::max(1e-3 * expected, 3e-4));
+    }
+
+    // Delay of the passband, measured as the centroid of the impulse response
+    const auto& coeffs = minimum.coefficients();
+    double centroid = 0.0;
+
+    for (size_t i = 0; i < coeffs.size(); ++i)
+        centroid += static_cast<double>(i) * coeffs[i];
+
+    centroid /= std::accumulate(coeffs.begin(), coeffs.end(), 0.0);
+    assert(centroid < (linear.size() - 1) / 4.0);
+
+    // All methods accept the converted filter
+    const auto signal = makeTestSignal(5000);
+
+    std::vector<double> direct(minimum.outputSize(signal.size()));
+    std::vector<double> viaFft(direct.size());
+
+    minimum.apply(signal, direct, 1.0, SincFilter::Method::Direct);
+    minimum.apply(signal, viaFft, 1.0, SincFilter::Method::Fft);
+
+    assert(maximumDifference(direct, viaFft) < 1e-12);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testChannelizer()
+{
+    static constexpr size_t Channels = 8;
+
+    const auto prototype = SincFilter::lowPass(0.5 / Channels, 0.02, 60.0).value();
+    const auto& h = prototype.coefficients();
+
+    const auto signal = makeTestSignal(1500);
+
+    PolyphaseChannelizer channelizer(prototype, Channels);
+
+    const size_t frames = channelizer.outputSize(signal.size());
+    std::vector<std::complex<double>> block(frames * Channels);
+    channelizer.apply(signal, block);
+
+    // Each channel is the decimated output of a complex band-pass filter
+    double error = 0.0;
+
+    for (size_t m = 0; m < frames; ++m)
+    {
+        for (size_t k = 0; k < Channels; ++k)
+        {
+            std::complex<double> expected = 0.0;
+
+            for (size_t i = 0; i < h.size(); ++i)
+            {
+                const size_t n = m * Channels - i;
+
+                if (m * Channels >= i && n < signal.size())
+                {
+                    const double phase = 2.0 * std::numbers::pi * static_cast<double>(k * i) /
+                                         static_cast<double>(Channels);
+
+                    expected += h[i] * std::polar(1.0, phase) * signal[n];
+                }
+            }
+
+            error = std::max(error, std::abs(block[m * Channels + k] - expected));
+        }
+    }
+
+    assert(error < 1e-12);
+
+    // Real input gives conjugate symmetric channels
+    for (size_t m = 0; m < frames; ++m)
+    {
+        for (size_t k = 1; k < Channels; ++k)
+            assert(std::abs(block[m * Channels + k] - std::conj(block[m * Channels + Channels - k]))
+                   < 1e-12);
+    }
+
+    // Streaming in blocks of varying size gives the leading frames of the block form
+    std::vector<std::complex<double>> streamed(frames * Channels);
+    size_t written = 0;
+
+    for (size_t start = 0, size = 1; start < signal.size(); start += size, size = size * 3 % 97)
+    {
+        const auto part = std::span(signal).subspan(start, std::min(size, signal.size() - start));
+        written += channelizer.process(part, std::span(streamed).subspan(written * Channels));
+    }
+
+    assert(written == (signal.size() + Channels - 1) / Channels);
+
+    for (size_t i = 0; i < written * Channels; ++i)
+        assert(std::abs(streamed[i] - block[i]) < 1e-12);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testConstexprDesign()
+{
+    using WindowType = SincFilter::WindowType;
+
+    // Evaluated by the compiler
+    static constexpr auto LowPass = SincDesign<121>::lowPass(0.4, WindowType::Blackman);
+    static_assert(LowPass[0] == LowPass[120] && LowPass[60] > 0.7);
+
+    [[maybe_unused]] static constexpr auto BandPass =
+        SincDesign<1001>::bandPass(0.1, 0.3, WindowType::Hamming);
+
+    [[maybe_unused]] static constexpr auto Kaiser =
+        SincDesign<255>::highPass(0.2, SincFilter::Window::kaiser(6.0));
+
+    [[maybe_unused]] const auto compare = [](std::span<const double> coeffs,
+                                             const SincFilter& filter) {
+        return maximumDifference(coeffs, filter.coefficients()) < 1e-14;
+    };
+
+    assert(compare(LowPass, SincFilter::lowPass(121, 0.4, WindowType::Blackman)));
+    assert(compare(BandPass, SincFilter::bandPass(1001, 0.1, 0.3, WindowType::Hamming)));
+    assert(compare(Kaiser, SincFilter::highPass(255, 0.2, SincFilter::Window::kaiser(6.0))));
+
+    assert(compare(SincDesign<51>::stopBand(0.15, 0.35),
+                   SincFilter::stopBand(51, 0.15, 0.35)));
+
+    // The arrays are used by the filter engines through spans
+    auto filter = SincFilter(LowPass);
+    assert(filter.isSymmetric());
+
+    const auto signal = makeTestSignal(1000);
+
+    std::vector<double> output(filter.outputSize(signal.size()));
+    filter.apply(signal, output);
+
+    SincFilterStream stream(LowPass);
+    std::vector<double> streamed(signal.size());
+    stream.process(signal, streamed);
+
+    assert(maximumDifference(streamed, output) < 1e-14);
+
+    // Filtering with the array itself allocates nothing
+    for (auto mode : { SincFilter::Mode::Full, SincFilter::Mode::Same, SincFilter::Mode::Valid })
+    {
+        std::vector<double> expected(filter.outputSize(signal.size(), mode));
+        filter.apply(signal, expected, mode, 0.5, SincFilter::Method::Direct);
+
+        std::vector<double> direct(expected.size());
+
+        [[maybe_unused]] const size_t before = allocations;
+        SincFilter::applyCoefficients(LowPass, signal, direct, mode, 0.5);
+
+        assert(allocations == before);
+        assert(direct == expected);
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testBatch()
+{
+    static constexpr size_t Signals = 37;
+    static constexpr size_t SignalSize = 600;
+
+    ThreadPool pool(3);
+
+    const auto signals = makeTestSignal(Signals * SignalSize);
+    const auto symmetric = SincFilter::lowPass(63, 0.2, SincFilter::WindowType::Blackman);
+
+    for (auto filter : { symmetric, symmetric.minimumPhase() })
+    {
+        for (auto mode : { SincFilter::Mode::Full, SincFilter::Mode::Same,
+                           SincFilter::Mode::Valid })
+        {
+            const size_t outputSize = filter.outputSize(SignalSize, mode);
+
+            std::vector<double> batch(Signals * outputSize);
+            filter.applyBatch(signals, SignalSize, batch, mode, 0.5);
+
+            // Each signal is filtered independently
+            for (size_t i = 0; i < Signals; ++i)
+            {
+                std::vector<double> single(outputSize);
+                filter.apply(std::span(signals).subspan(i * SignalSize, SignalSize), single, mode,
+                             0.5, SincFilter::Method::Direct);
+
+                assert(maximumDifference(single,
+                                         std::span(batch).subspan(i * outputSize)) < 1e-14);
+            }
+
+            std::vector<double> parallel(batch.size());
+            filter.applyBatch(pool, signals, SignalSize, parallel, mode, 0.5);
+
+            assert(parallel == batch);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+template <typename T>
+static void writeSamples(const std::filesystem::path& path, std::span<const T> samples)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(samples.data()),
+               static_cast<std::streamsize>(samples.size_bytes()));
+}
+
+template <typename T>
+static auto readSamples(const std::filesystem::path& path) -> std::vector<T>
+{
+    std::vector<T> samples(std::filesystem::file_size(path) / sizeof(T));
+
+    std::ifstream file(path, std::ios::binary);
+    file.read(reinterpret_cast<char*>(samples.data()),
+              static_cast<std::streamsize>(samples.size() * sizeof(T)));
+
+    return samples;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testSampleFiles()
+{
+    // Several blocks with a partial one at the end
+    static constexpr size_t SignalSize = 2 * SampleFile::BlockSize + 1234;
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto inputPath = directory / "sincfilter_input.raw";
+    const auto outputPath = directory / "sincfilter_output.raw";
+
+    auto signal = makeTestSignal(SignalSize);
+
+    for (auto& x : signal)
+        x *= 0.5;
+
+    const auto filter = SincFilter::lowPass(255, 0.1, SincFilter::WindowType::Blackman);
+
+    writeSamples<double>(inputPath, signal);
+
+    // Both streaming engines, the FFT convolver with its delay of one block
+    for (auto method : { SincFilter::Method::Direct, SincFilter::Method::Fft })
+    {
+        for (auto mode : { SincFilter::Mode::Full, SincFilter::Mode::Same,
+                           SincFilter::Mode::Valid })
+        {
+            std::vector<double> expected(filter.outputSize(SignalSize, mode));
+            filter.apply(signal, expected, mode, 0.5, SincFilter::Method::Direct);
+
+            [[maybe_unused]] const bool ok = SampleFile::filter(
+                filter, inputPath, SampleFile::Format::Float64, outputPath,
+                SampleFile::Format::Float64, mode, 0.5, method);
+
+            assert(ok);
+
+            [[maybe_unused]] const auto output = readSamples<double>(outputPath);
+
+            assert(output.size() == expected.size());
+            assert(maximumDifference(output, expected) < 1e-12);
+        }
+    }
+
+    // Single precision and Q15 samples, compared with the filtered quantized input
+    std::vector<float> floats(signal.begin(), signal.end());
+    std::vector<int16_t> integers(SignalSize);
+
+    for (size_t i = 0; i < SignalSize; ++i)
+        integers[i] = Q15::fromDouble(signal[i]).value;
+
+    writeSamples<float>(inputPath, floats);
+
+    {
+        const std::vector<double> input(floats.begin(), floats.end());
+        std::vector<double> expected(SignalSize);
+        filter.apply(input, expected, SincFilter::Mode::Same);
+
+        [[maybe_unused]] const bool ok = SampleFile::filter(
+            filter, inputPath, SampleFile::Format::Float32, outputPath,
+            SampleFile::Format::Float32);
+
+        assert(ok);
+
+        [[maybe_unused]] const auto output = readSamples<float>(outputPath);
+
+        assert(output.size() == SignalSize);
+
+        for (size_t i = 0; i < SignalSize; ++i)
+            assert(std::abs(output[i] - expected[i]) < 1e-6);
+    }
+
+    writeSamples<int16_t>(inputPath, integers);
+
+    {
+        std::vector<double> input(SignalSize);
+
+        for (size_t i = 0; i < SignalSize; ++i)
+            input[i] = Q15{ integers[i] }.toDouble();
+
+        std::vector<double> expected(SignalSize);
+        filter.apply(input, expected, SincFilter::Mode::Same);
+
+        [[maybe_unused]] const bool ok = SampleFile::filter(
+            filter, inputPath, SampleFile::Format::Int16, outputPath, SampleFile::Format::Int16);
+
+        assert(ok);
+
+        [[maybe_unused]] const auto output = readSamples<int16_t>(outputPath);
+
+        assert(output.size() == SignalSize);
+
+        for (size_t i = 0; i < SignalSize; ++i)
+            assert(std::abs(output[i] - Q15::fromDouble(expected[i]).value) <= 1);
+    }
+
+    // Empty input, a truncated sample and a missing file
+    writeSamples<int16_t>(inputPath, {});
+
+    [[maybe_unused]] const bool empty = SampleFile::filter(
+        filter, inputPath, SampleFile::Format::Int16, outputPath, SampleFile::Format::Float64);
+
+    assert(empty && std::filesystem::file_size(outputPath) == 0);
+
+    writeSamples<char>(inputPath, std::array<char, 3>{});
+
+    [[maybe_unused]] const bool truncated = SampleFile::filter(
+        filter, inputPath, SampleFile::Format::Int16, outputPath, SampleFile::Format::Int16);
+
+    std::filesystem::remove(inputPath);
+    std::filesystem::remove(outputPath);
+
+    [[maybe_unused]] const bool missing = SampleFile::filter(
+        filter, inputPath, SampleFile::Format::Float64, outputPath, SampleFile::Format::Float64);
+
+    assert(!truncated && !missing);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+static void testAllocations()
+{
+    static constexpr size_t BlockSize = 480;
+    static constexpr size_t Blocks = 20;
+
+    // Designs can be placed in a caller-provided arena
+    std::array<std::byte, 16384> memory;
+    std::pmr::monotonic_buffer_resource arena(memory.data(), memory.size(),
+                                              std::pmr::null_memory_resource());
+
+    [[maybe_unused]] size_t before = allocations;
+
+    const auto filter = SincFilter::lowPass(101, 0.1, SincFilter::WindowType::Blackman, &arena);
+    const auto highPass = SincFilter::highPass(101, 0.3, SincFilter::WindowType::Blackman, &arena);
+    const auto combined = filter + highPass;
+
+    assert(allocations == before);
+    assert(combined.resource() == &arena);
+
+    const auto signal = makeTestSignal(BlockSize * Blocks);
+
+    FilterWorkspace workspace(filter);
+    SincFilterStream stream(filter);
+    FftConvolver convolver(filter.coefficients());
+    PolyphaseDecimator decimator(filter, 4);
+    PolyphaseChannelizer channelizer(filter, 8);
+    FractionalResampler resampler(0.75);
+
+    std::vector<double> output(filter.outputSize(BlockSize));
+    std::vector<double> block(BlockSize);
+    std::vector<std::complex<double>> channels(BlockSize);
+    std::vector<double> resampled(resampler.maximumOutputSize(BlockSize));
+
+    const auto run = [&](std::span<const double> input) {
+        filter.apply(workspace, input, output, SincFilter::Mode::Full, 0.5,
+                     SincFilter::Method::Direct);
+        filter.apply(workspace, input, output, SincFilter::Mode::Same, 1.0,
+                     SincFilter::Method::Fft);
+
+        std::copy(input.begin(), input.end(), block.begin());
+        filter.applyInPlace(workspace, block, 2.0);
+
+        stream.process(input, block);
+        convolver.process(input, block);
+        decimator.process(input, block);
+        channelizer.process(input, channels);
+        resampler.process(input, resampled);
+    };
+
+    // Everything is allocated on construction
+    before = allocations;
+
+    for (size_t i = 0; i < Blocks; ++i)
+        run(std::span(signal).subspan(i * BlockSize, BlockSize));
+
+    assert(allocations == before);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
 auto main() -> int
 {
+    testConvolutionKernel();
+    testFftConvolution();
+    testStreaming();
+    testPolyphase();
+    testResampling();
+    testMultichannel();
+    testSampleTypes();
+    testExpressions();
+    testDesignCache();
+    testDesignAccuracy();
+    testOutputModes();
+    testParallel();
+    testKaiserDesign();
+    testMinimumPhase();
+    testChannelizer();
+    testConstexprDesign();
+    testBatch();
+    testAllocations();
+    testSampleFiles();
+
     static constexpr double TwoPi = 2.0 * 3.14159265358979323846;
 
     static constexpr size_t SignalSize = 1000;
@@ -0,0 +1,249 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+// ---------------------------------------------------------------------------------------------- //
+
+namespace {
+    // Set while a thread executes tasks, nested jobs then run serially instead of deadlocking
+    thread_local bool t_insideJob = false;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    m_ranges = std::make_unique<Range[]>(threads);
+
+    for (size_t i = 0; i < threads; ++i)
+        m_ranges[i].bounds = 0;
+
+    // The last range belongs to the calling thread
+    for (size_t i = 0; i + 1 < threads; ++i)
+        m_workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto ThreadPool::size() const -> size_t
+{
+    return m_workers.size() + 1;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    if (m_workers.empty() || count < 2 || t_insideJob)
+    {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+
+        return;
+    }
+
+    assert(count <= UINT32_MAX);
+
+    std::lock_guard job(m_jobMutex);
+
+    const size_t threads = size();
+
+    for (size_t i = 0; i < threads; ++i)
+        m_ranges[i].bounds = pack(count * i / threads, count * (i + 1) / threads);
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        m_task = &task;
+        m_active = m_workers.size();
+        m_failed = false;
+        ++m_generation;
+    }
+
+    m_wake.notify_all();
+
+    run(threads - 1);
+
+    std::unique_lock lock(m_mutex);
+    m_done.wait(lock, [this] { return m_active == 0; });
+
+    m_task = nullptr;
+
+    if (m_exception)
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto ThreadPool::pack(uint64_t begin, uint64_t end) -> uint64_t
+{
+    return begin << 32 | end;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ThreadPool::work(size_t thread)
+{
+    size_t generation = 0;
+
+    std::unique_lock lock(m_mutex);
+
+    while (true)
+    {
+        m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+
+        if (m_stop)
+            return;
+
+        generation = m_generation;
+
+        lock.unlock();
+        run(thread);
+        lock.lock();
+
+        if (--m_active == 0)
+            m_done.notify_one();
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+void ThreadPool::run(size_t thread)
+{
+    t_insideJob = true;
+
+    try
+    {
+        do
+        {
+            size_t index;
+
+            while (!m_failed && take(thread, index))
+                (*m_task)(index);
+        }
+        while (!m_failed && steal(thread));
+    }
+    catch (...)
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (!m_exception)
+            m_exception = std::current_exception();
+
+        m_failed = true;
+    }
+
+    t_insideJob = false;
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto ThreadPool::take(size_t thread, size_t& index) -> bool
+{
+    auto& bounds = m_ranges[thread].bounds;
+    uint64_t value = bounds.load();
+
+    while (true)
+    {
+        const uint64_t begin = value >> 32;
+        const uint64_t end = value & UINT32_MAX;
+
+        if (begin >= end)
+            return false;
+
+        if (bounds.compare_exchange_weak(value, pack(begin + 1, end)))
+        {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------- //
+
+auto ThreadPool::steal(size_t thread) -> bool
+{
+    const size_t threads = size();
+
+    for (size_t i = 1; i < threads; ++i)
+    {
+        auto& bounds = m_ranges[(thread + i) % threads].bounds;
+        uint64_t value = bounds.load();
+
+        while (true)
+        {
+            const uint64_t begin = value >> 32;
+            const uint64_t end = value & UINT32_MAX;
+
+            if (begin >= end)
+                break;
+
+            // Leave the lower half to the owner, which is working its way up
+            const uint64_t middle = begin + (end - begin) / 2;
+
+            if (bounds.compare_exchange_weak(value, pack(begin, middle)))
+            {
+                // The own range is empty, so nobody else modifies it concurrently
+                m_ranges[thread].bounds = pack(middle, end);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// ---------------------------------------------------------------------------------------------- //
@@ -0,0 +1,103 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads executing indexed tasks. Each thread starts on its own contiguous
+// range of indices and, once that is exhausted, steals the upper half of the remaining range of
+// another thread, so uneven task durations are balanced without a shared queue.
+class ThreadPool
+{
+public:
+    // Total number of threads including the calling thread, zero uses all hardware threads
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+    auto size() const -> size_t;
+
+    // Calls task(i) for all i < count and returns when all calls have finished. The calling
+    // thread takes part. Calls from within a task run serially on the calling thread. If a task
+    // throws, the remaining indices are skipped and the first exception is rethrown once all
+    // threads have stopped.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    // Begin and end of the remaining indices packed into one word, so that the owner and
+    // thieves can update them with a single compare-and-swap
+    struct alignas(64) Range
+    {
+        std::atomic<uint64_t> bounds;
+    };
+
+    static auto pack(uint64_t begin, uint64_t end) -> uint64_t;
+
+    void work(size_t thread);
+    void run(size_t thread);
+
+    auto take(size_t thread, size_t& index) -> bool;
+    auto steal(size_t thread) -> bool;
+
+private:
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<Range[]> m_ranges;
+
+    // Serializes jobs submitted by different threads
+    std::mutex m_jobMutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::function<void(size_t)>* m_task = nullptr;
+    size_t m_generation = 0;
+    size_t m_active = 0;
+    bool m_stop = false;
+
+    // First exception thrown by a task of the current job
+    std::atomic<bool> m_failed = false;
+    std::exception_ptr m_exception;
+};
@@ -0,0 +1,209 @@
+// ============================================================================================== //
+//                                                                                                //
+//   This file is part of the ISF Utilities collection.                                           //
+//                                                                                                //
+//   Author:                                                                                      //
+//   Marcel Hasler <mahasler@gmail.com>                                                           //
+//                                                                                                //
+//   Copyright (c) 2022 - 2023                                                                    //
+//   Bonn-Rhein-Sieg University of Applied Sciences                                               //
+//                                                                                                //
+//   Redistribution and use in source and binary forms, with or without modification,             //
+//   are permitted provided that the following conditions are met:                                //
+//                                                                                                //
+//   1. Redistributions of source code must retain the above copyright notice,                    //
+//      this list of conditions and the following disclaimer.                                     //
+//                                                                                                //
+//   2. Redistributions in binary form must reproduce the above copyright notice,                 //
+//      this list of conditions and the following disclaimer in the documentation                 //
+//      and/or other materials provided with the distribution.                                    //
+//                                                                                                //
+//   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"                  //
+//   AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED            //
+//   WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.           //
+//   IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,             //
+//   INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT           //
+//   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR           //
+//   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,            //
+//   WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)           //
+//   ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE                   //
+//   POSSIBILITY OF SUCH DAMAGE.                                                                  //
+//                                                                                                //
+// ============================================================================================== //
+#pragma once
+
+#include "convolutionkernel.h"
+#include "fixedpoint.h"
+#include "sincfilter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Arithmetic used by TypedFilter for a sample type. Coefficients are quantized to the sample
+// format, products are summed in an accumulator that is converted back to a sample at the end.
+template <typename Sample>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<float>
+{
+    using Coefficient = float;
+    using Accumulator = float;
+
+    static auto quantize(double c) -> Coefficient
+    {
+        return static_cast<float>(c);
+    }
+
+    static auto multiplyAdd(Accumulator a, float x, Coefficient c) -> Accumulator
+    {
+        return a + x * c;
+    }
+
+    static auto result(Accumulator a) -> float
+    {
+        return a;
+    }
+};
+
+// Fixed-point samples are accumulated exactly in 64 bits. Q15 products are summed directly. Q31
+// products have 62 fraction bits and are split at bit 31 into a signed upper and a non-negative
+// lower part, which are summed separately and leave 32 guard bits each. Only the final result is
+// rounded and saturated, so intermediate overflow cannot occur for any practical filter size.
+template <typename T, int Bits>
+struct SampleTraits<FixedPoint<T, Bits>>
+{
+    using Sample = FixedPoint<T, Bits>;
+    using Coefficient = FixedPoint<T, Bits>;
+
+    struct SplitSum
+    {
+        int64_t upper = 0;
+        int64_t lower = 0;
+    };
+
+    static constexpr bool Split = sizeof(T) >= 4;
+    static constexpr int64_t LowerMask = (int64_t(1) << Bits) - 1;
+
+    using Accumulator = std::conditional_t<Split, SplitSum, int64_t>;
+
+    static auto quantize(double c) -> Coefficient
+    {
+        return Coefficient::fromDouble(c);
+    }
+
+    static auto multiplyAdd(Accumulator a, Sample x, Coefficient c) -> Accumulator
+    {
+        const int64_t product = static_cast<int64_t>(x.value) * c.value;
+
+        if constexpr (Split)
+            return { a.upper + (product >> Bits), a.lower + (product & LowerMask) };
+        else
+            return a + product;
+    }
+
+    static auto result(Accumulator a) -> Sample
+    {
+        static constexpr int64_t Half = int64_t(1) << (Bits - 1);
+
+        if constexpr (Split)
+            return Sample::saturate(a.upper + ((a.lower + Half) >> Bits));
+        else
+            return Sample::saturate((a + Half) >> Bits);
+    }
+};
+
+// Applies a filter designed by SincFilter to samples of another type, e.g. float to halve the
+// memory bandwidth or Q15 and Q31 fixed point for processors without floating-point unit. The
+// coefficients are quantized once on construction. Float uses the SIMD convolution kernels,
+// fixed point portable integer code.
+template <typename Sample>
+class TypedFilter
+{
+public:
+    using Traits = SampleTraits<Sample>;
+    using Coefficient = typename Traits::Coefficient;
+
+public:
+    explicit TypedFilter(const SincFilter& filter)
+        : TypedFilter(filter.coefficients())
+    {
+    }
+
+    explicit TypedFilter(std::span<const double> coeffs)
+    {
+        assert(!coeffs.empty());
+
+        m_reversed.reserve(coeffs.size());
+
+        for (auto it = coeffs.rbegin(); it != coeffs.rend(); ++it)
+            m_reversed.push_back(Traits::quantize(*it));
+    }
+
+    auto size() const -> size_t
+    {
+        return m_reversed.size();
+    }
+
+    // Full convolution like SincFilter::apply(), output must hold input.size() + size() - 1
+    // samples
+    void apply(std::span<const Sample> input, std::span<Sample> output) const
+    {
+        const size_t n = input.size();
+        const size_t m = m_reversed.size();
+
+        assert(output.size() >= n + m - 1);
+
+        // Output i depends on input[i - (m - 1) + k] for those k that lie inside the input
+        const auto edge = [&](size_t i) {
+            const size_t first = i < m - 1 ? m - 1 - i : 0;
+            const size_t last = std::min(m, n + m - 1 - i);
+
+            correlate(&input[i + first - (m - 1)], &m_reversed[first], last - first, &output[i],
+                      1);
+        };
+
+        if (n < m)
+        {
+            for (size_t i = 0; i < n + m - 1; ++i)
+                edge(i);
+
+            return;
+        }
+
+        for (size_t i = 0; i < m - 1; ++i)
+            edge(i);
+
+        correlate(input.data(), m_reversed.data(), m, &output[m - 1], n - m + 1);
+
+        for (size_t i = n; i < n + m - 1; ++i)
+            edge(i);
+    }
+
+private:
+    static void correlate(const Sample* input, const Coefficient* reversed, size_t taps,
+                          Sample* output, size_t count)
+    {
+        if constexpr (std::is_same_v<Sample, float>)
+            ConvolutionKernel::correlate(input, reversed, taps, output, count);
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                typename Traits::Accumulator a = {};
+
+                for (size_t k = 0; k < taps; ++k)
+                    a = Traits::multiplyAdd(a, input[i + k], reversed[k]);
+
+                output[i] = Traits::result(a);
+            }
+        }
+    }
+
+private:
+    std::vector<Coefficient> m_reversed;
+};